@@ -7,6 +7,31 @@
  **-----------------------------------------------------------------------------
  ** 01.06.2021  JE    Created program.
  ** 06.06.2022  JE    Now the maze got more straight lines.
+ ** 16.10.2026  JE    Walls are bits in an 'uint8_t' grid now, added '--bench'.
+ ** 16.10.2026  JE    Added large mode with 2 bits per cell and '-o' export.
+ ** 16.10.2026  JE    Replaced 'rand()' with seedable per maze xoshiro256**.
+ ** 16.10.2026  JE    Added '--no-animate' and batch generation with '--count'.
+ ** 16.10.2026  JE    All maze state lives in a 't_maze' context, added '-t'.
+ ** 16.10.2026  JE    Added '--algo' and the tile parallel generator.
+ ** 16.10.2026  JE    Added Eller's generator, streams rows without a grid.
+ ** 16.10.2026  JE    Added Kruskal's generator with a parallel edge shuffle.
+ ** 16.10.2026  JE    Added Wilson's generator for uniform spanning trees.
+ ** 16.10.2026  JE    Added binary tree and sidewinder generators, word wise.
+ ** 16.10.2026  JE    Added growing tree generator with '--policy'.
+ ** 16.10.2026  JE    Backtracker keeps masks of whole neighbours per cell.
+ ** 16.10.2026  JE    Stack holds 2 bit directions, added its high water mark.
+ ** 16.10.2026  JE    Added bitboards with a bit parallel flood for small mazes.
+ ** 16.10.2026  JE    Added a breadth first solver and '--solve'.
+ ** 16.10.2026  JE    Added a tree index for distances between any two cells.
+ ** 16.10.2026  JE    Added the junction graph and '--stats'.
+ ** 16.10.2026  JE    Added A* and bidirectional solvers, '--solver' and '--braid'.
+ ** 16.10.2026  JE    Added the dead end filling solver on bitboard row bands.
+ ** 16.10.2026  JE    Added the distance field, '--dist' and in game hints.
+ ** 16.10.2026  JE    Frames are composed in a buffer and written at once.
+ ** 16.10.2026  JE    Moves only send the changed cells and the status lines.
+ ** 16.10.2026  JE    The grid is shown in a scrolling view of the terminal's size.
+ ** 16.10.2026  JE    Added the first person view, composed from templates.
+ ** 16.10.2026  JE    The first person view reads precomputed sight records.
  *******************************************************************************/
 
 
@@ -15,9 +40,14 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <string.h>
+#include <errno.h>
+#include <limits.h>
 #include <termios.h>
 #include <unistd.h>
+#include <sys/ioctl.h>
+#include <pthread.h>
 
 #include "c_string.h"
 #include "c_dynamic_arrays_macros.h"
@@ -26,7 +56,7 @@
 //******************************************************************************
 //* defines & macros
 
-#define ME_VERSION "0.1.2"
+#define ME_VERSION "0.26.0"
 cstr g_csMename;
 
 #define ERR_NOERR 0x00
@@ -38,34 +68,132 @@ cstr g_csMename;
 #define sERR_FILE  "File error"
 #define sERR_ELSE  "Unknown error"
 
-// Walls in grid.        //     N          2
-#define CELL_NORTH   2   //     |          |
-#define CELL_WEST    3   // W --+-- E  3 --+-- 5
-#define CELL_SOUTH   5   //     |          |
-#define CELL_EAST    7   //     S          7
-#define CELL_NONE    0
-#define CELL_BORDER -1
-#define CELL_WHOLE (CELL_NORTH * CELL_WEST * CELL_SOUTH * CELL_EAST)
-// The prime numbers multiplied equal 210 = 2 * 3 * 5 * 7
-
-char g_dChar[] = "^<v>";
-
 #define DIR_NORTH 0x00
 #define DIR_WEST  0x01
 #define DIR_SOUTH 0x02
 #define DIR_EAST  0x03
 #define DIR_MOD   4
 
+// Walls in grid, one bit per direction. //     N          1
+#define CELL_NORTH  (1 << DIR_NORTH)     //     |          |
+#define CELL_WEST   (1 << DIR_WEST)      // W --+-- E  2 --+-- 8
+#define CELL_SOUTH  (1 << DIR_SOUTH)     //     |          |
+#define CELL_EAST   (1 << DIR_EAST)      //     S          4
+#define CELL_NONE   0x00
+#define CELL_BORDER 0x80
+#define CELL_WHOLE  (CELL_NORTH | CELL_WEST | CELL_SOUTH | CELL_EAST)
+// All four wall bits set equal 0x0f, the border flag never matches a cell.
+
+// Walls in large grid, 2 bits per cell. North and west walls are the south and
+// east walls of the neighbours. Border cells have at least one of their own
+// bits cleared, so they never look whole.
+#define PACK_SOUTH 0x01
+#define PACK_EAST  0x02
+#define PACK_BOTH  (PACK_SOUTH | PACK_EAST)
+#define PACK_SHIFT 5   // 32 cells per uint64_t word.
+#define PACK_MASK  31
+#define PACK_EVEN  0x5555555555555555ULL  // South bits of a word.
+
+char g_dChar[] = "^<v>";
+
 #define MOVE_FRONT 0x00
 #define MOVE_LEFT  0x01
 #define MOVE_BACK  0x02
 #define MOVE_RIGHT 0x03
 #define MOVE_MOD   4
 
-#define GRID_MAX 100
+#define GRID_MAX       100
+#define GRID_MAX_LARGE 0x40000000  // Per side, in large mode.
 
 #define STACK_EMPTY 0
 
+#define RAND_BUF_SIZE 64  // Random words generated at once.
+
+// Generators, see g_acAlgo for their names.
+#define ALGO_BACKTRACK 0x00
+#define ALGO_TILES     0x01
+#define ALGO_ELLER     0x02
+#define ALGO_KRUSKAL   0x03
+#define ALGO_WILSON    0x04
+#define ALGO_BINARY    0x05
+#define ALGO_SIDEWIND  0x06
+#define ALGO_GROWING   0x07
+#define ALGO_COUNT     8
+
+// Cell selection of the growing tree, see g_acPolicy for their names.
+#define POLICY_NEWEST 0x00
+#define POLICY_RANDOM 0x01
+#define POLICY_OLDEST 0x02
+#define POLICY_MIX    0x03  // Random with iMix percent, else newest.
+#define POLICY_COUNT  4
+
+#define TILE_SIZE 256  // Side length of a tile in the parallel generator.
+
+#define KRUSKAL_CHUNK   0x10000  // Edge slots per shuffle chunk, even.
+#define KRUSKAL_BUCKETS 256      // Buckets of the parallel shuffle, 8 bits.
+#define KRUSKAL_MAX     0x7fffffff  // Cells, edges are (cell << 1 | south).
+
+const char* g_acAlgo[ALGO_COUNT] = {"backtrack", "tiles", "eller", "kruskal", "wilson",
+                                 "binary", "sidewinder", "growing"};
+const char* g_acPolicy[POLICY_COUNT] = {"newest", "random", "oldest", "mix"};
+
+#define BOARD_MAX_W 256  // Widest maze a bitboard holds, 4 words per row.
+
+#define SOLVE_QUEUE 0x10000  // Initial frontier slots, doubled when full.
+
+// Solvers, see g_acSolver for their names.
+#define SOLVER_BFS     0x00
+#define SOLVER_ASTAR   0x01
+#define SOLVER_BIDIR   0x02
+#define SOLVER_DEADEND 0x03
+#define SOLVER_COUNT   4
+
+const char* g_acSolver[SOLVER_COUNT] = {"bfs", "astar", "bidir", "deadend"};
+
+#define FILL_BANDS 4  // Row bands per thread of the dead end filler.
+
+#define RADIX_BUCKETS 65    // One per highest differing bit of a 64 bit key.
+#define RADIX_FIRST   1024  // Entries of a bucket's first allocation.
+
+#define TREE_BLOCK 32           // Depths per block of the in-block minima.
+#define TREE_MAX   0xffffffffLL  // Grid cells, the index holds 32 bit cells.
+
+#define GRAPH_NONE UINT32_MAX  // Node of a corridor cell.
+#define GRAPH_MAX  0x7fffffffLL  // Grid cells, edges are counted in 32 bits.
+
+#define DIST_NONE  0xffffffffU  // Border cells and cells without way out.
+#define DIST_CHUNK 0x1000       // Edges per chunk of the distance threads.
+#define DIST_BYTES 20           // Peak bytes per grid cell while building.
+
+#define FRAME_HOME  "\x1b[H"  // Cursor to the upper left corner.
+#define FRAME_EOL   "\x1b[K"  // Clear the rest of the line.
+#define FRAME_EOS   "\x1b[J"  // Clear the rest of the screen.
+#define FRAME_GOTO  "\x1b[%d;%dH"  // Cursor to row and column, from 1.
+#define FRAME_SAVE  "\x1b" "7"    // Remember the cursor ...
+#define FRAME_BACK  "\x1b" "8"    // ... and go back there.
+#define FRAME_SLACK 256       // Bytes per frame for status lines.
+#define FRAME_LINES 2         // Lines below the grid, position and hint.
+#define FRAME_BENCH 1000      // Widest and highest maze the frame bench draws.
+
+// First person view right of the grid, see viewInit() for its planes.
+#define VIEW_DEPTH 5   // Cells seen ahead of the own one.
+#define VIEW_W     41
+#define VIEW_H     21
+#define VIEW_GAP   2   // Columns between grid and view.
+#define VIEW_PARTS 2   // Side wall or side opening.
+
+// Sight of a cell in a direction in 16 bits, as viewWalk() returns it.
+#define SIGHT_OPENS 0x3f    // Side openings, a bit per depth (VIEW_DEPTH + 1).
+#define SIGHT_RIGHT 6       // Shift of the right side's openings.
+#define SIGHT_DEPTH 12      // Shift of the depth of the last cell in sight.
+#define SIGHT_FRONT 0x8000  // Wall behind the last cell.
+#define SIGHT_MAX   0x400000LL  // Grid cells with records, 32 MB of them.
+
+#define FRAME_COLS (4 * GRID_MAX + 1 + VIEW_GAP + VIEW_W)  // Screen if there is
+#define FRAME_ROWS (2 * GRID_MAX + 1 + FRAME_LINES)        // no terminal to ask.
+
+#define BENCH_TIME 1.0  // Minimal run time of each benchmark in seconds.
+
 
 //******************************************************************************
 //* outsourced standard functions, includes and defines
@@ -78,26 +206,263 @@ char g_dChar[] = "^<v>";
 
 // Arguments and options.
 typedef struct s_options {
-  int iMazeW;
-  int iMazeH;
+  int  iMazeW;
+  int  iMazeH;
+  int  bBench;
+  int  bLarge;
+  cstr csOut;
+  ll   llSeed;
+  int  bAnimate;
+  int  iCount;
+  int  iThreads;
+  int  iAlgo;
+  int  iPolicy;
+  int  iMix;
+  int  bSolve;
+  int  bStats;
+  int  iSolver;
+  int  iBraid;
+  int  bDist;
 } t_options;
 
-// Arguments and options.
-typedef struct s_grid {
-  int  iMazeW;      // Width of maze
-  int  iMazeH;      // Height of maze
-  int  iGridW;      // = iMazeW + border (2)
-  int  iGridH;      // = iMazeH + border (2)
-  int  iMazeCount;  // = iMazeW * iMazeH
-  int  iGridCount;  // = iGridW * iGridH
-  int* piCells;
-} t_grid;
+// xoshiro256** state with a buffer of pre-generated words and a bit reservoir.
+typedef struct s_rand {
+  uint64_t aui64State[4];
+  uint64_t aui64Buf[RAND_BUF_SIZE];
+  int      iBufPos;     // Next unused word in buffer.
+  uint64_t ui64Bits;    // Reservoir for small draws.
+  int      iBitsLeft;   // Unused bits in reservoir.
+} t_rand;
 
+// Backtracker's path as the directions taken, cells are found by walking back.
 typedef struct s_stack {
-  int*   piCell;
-  size_t sStackSize;
+  uint8_t* pui8Dir;     // 2 bits per step, 4 steps per byte.
+  ll       llSize;      // Steps on the stack.
+  ll       llMaxSize;   // High water mark of the last generation.
 } t_stack;
 
+// Screen contents, composed in one buffer and written with a single write().
+// The screen's grid is remembered by its view and marker, so moves only send
+// changes.
+typedef struct s_frame {
+  char*  pcBuf;
+  size_t sLen;    // Bytes composed.
+  size_t sSize;   // Bytes allocated, only ever grows.
+  int    bDrawn;  // Screen shows the grid of the maze's current walls ...
+  ll     llCell;  // ... with the marker at this cell ...
+  int    iDir;    // ... in this direction.
+  int    iViewX;  // Upper left maze cell of the view.
+  int    iViewY;
+  int    iViewW;  // Cells in the view.
+  int    iViewH;
+  int    b3D;       // Leave room for the first person view ...
+  int    i3DRows;   // ... which fits in this many rows, 0 if it doesn't fit.
+  int    b3DDrawn;  // Screen shows ac3D.
+  char   ac3D[VIEW_H][VIEW_W];  // First person view on the screen.
+} t_frame;
+
+// Character templates of the first person view, each part of the view covers
+// its own columns. Side walls and openings are drawn into the columns between
+// their planes, the far end of the corridor into those of its last plane.
+typedef struct s_view {
+  int  aiX[VIEW_DEPTH + 2];  // Left column of each plane, the nearest is 0.
+  int  aiY[VIEW_DEPTH + 2];  // Upper row of each plane.
+  char acLeft[VIEW_PARTS][VIEW_DEPTH + 1][VIEW_H][VIEW_W];
+  char acRight[VIEW_PARTS][VIEW_DEPTH + 1][VIEW_H][VIEW_W];
+  char acFront[VIEW_DEPTH + 1][VIEW_H][VIEW_W];  // Wall behind the last cell.
+  char acFar[VIEW_H][VIEW_W];                    // Nothing ahead in sight.
+} t_view;
+
+#define VIEW_WALL 0
+#define VIEW_OPEN 1
+
+// What can be seen from each cell in each direction, see SIGHT_*.
+typedef struct s_sight {
+  uint16_t* pui16Rec;  // Index is cell * DIR_MOD + direction.
+} t_sight;
+
+// Maze context, owns everything one maze needs. No function touches another
+// maze, so any number of them can be worked on in parallel.
+typedef struct s_maze {
+  int       iMazeW;       // Width of maze
+  int       iMazeH;       // Height of maze
+  int       iGridW;       // = iMazeW + border (2)
+  int       iGridH;       // = iMazeH + border (2)
+  ll        llMazeCount;  // = iMazeW * iMazeH
+  ll        llGridCount;  // = iGridW * iGridH
+  int       bLarge;       // Use packed cells instead of wall bytes.
+  uint8_t*  pui8Cells;    // Wall bits per cell, see CELL_*
+  uint64_t* pui64Packed;  // Large mode: south and east wall per cell, see PACK_*
+  uint8_t*  pui8Around;   // Whole neighbours as CELL_* bits, 2 cells per byte.
+  int       bAround;      // pui8Around is allocated and kept up to date.
+  t_stack   tStack;       // Backtracker's stack, allocated while it runs.
+  t_rand    tRand;        // The maze's own random generator.
+  ll        llSeed;       // Seed tRand was started with.
+  int       iAlgo;        // Generator to use, see ALGO_*
+  int       iPolicy;      // Growing tree cell selection, see POLICY_*
+  int       iMix;         // Percent of random picks for POLICY_MIX.
+  int       iThreads;     // Threads a generator may use.
+  int       iBraid;       // Percent of dead ends opened after generation.
+  int       bShared;      // Threads write to the packed grid concurrently.
+  ll        llExit;       // Cell with the opening in the border ...
+  int       iExitDir;     // ... and the direction it opens to.
+  t_frame   tFrame;       // Screen of the game and the animation.
+} t_maze;
+
+// A rectangle of maze cells, carved by one thread.
+typedef struct s_tile {
+  int iX;  // Upper left maze cell.
+  int iY;
+  int iW;
+  int iH;
+} t_tile;
+
+// Shared state of the tile worker threads.
+typedef struct s_tiles {
+  t_maze* ptMaze;
+  int     iTilesW;  // Tiles per row.
+  int     iTilesH;  // Tiles per column.
+  int     iNext;    // Next tile to carve.
+  int     bFailed;  // A worker got no memory.
+} t_tiles;
+
+// Row state of Eller's generator, all arrays have one entry per column.
+typedef struct s_eller {
+  int       iW;
+  uint32_t* pui32Set;   // Set of each cell in the current row.
+  uint32_t* pui32Root;  // Union find parent of each set.
+  uint32_t* pui32Left;  // Cells of a set not looked at for a way south.
+  uint8_t*  pui8Down;   // Set has a way south.
+  uint8_t*  pui8East;   // Wall east of cell, result of ellerRow().
+  uint8_t*  pui8South;  // Wall south of cell, result of ellerRow().
+} t_eller;
+
+// Shared state of the Kruskal shuffle threads.
+typedef struct s_kruskal {
+  t_maze*   ptMaze;
+  uint32_t* pui32Edge;   // Shuffled edges as (cell << 1 | south).
+  uint32_t* pui32Count;  // Edges per chunk and bucket, then their offsets.
+  ll        llStart[KRUSKAL_BUCKETS + 1];  // First edge of each bucket.
+  ll        llSlots;     // Edge slots, two per cell, not all are walls.
+  int       iChunks;
+  int       iPass;       // KRUSKAL_COUNT, KRUSKAL_SCATTER or KRUSKAL_SHUFFLE.
+  int       iNext;       // Next chunk or bucket to work on.
+} t_kruskal;
+
+#define KRUSKAL_COUNT   0
+#define KRUSKAL_SCATTER 1
+#define KRUSKAL_SHUFFLE 2
+
+// Bitboard of a maze up to BOARD_MAX_W wide, bit x of a row is cell x + 1.
+typedef struct s_board {
+  int       iW;
+  int       iH;
+  int       iWords;      // Words per row.
+  uint64_t  ui64Last;    // Valid cells of a row's last word.
+  uint64_t* pui64East;   // Wall east of cell.
+  uint64_t* pui64South;  // Wall south of cell.
+  uint64_t* pui64Seen;   // Cells reached by the flood.
+  uint64_t* pui64Front;  // Cells reached in the last step.
+  uint64_t* pui64Next;   // Cells reached in this step.
+  int*      piRows;      // Front rows of the flood, two lists of iH + 1.
+} t_board;
+
+// Monotone priority queue, no key is pushed below the last popped one. Keys
+// are kept in buckets by the highest bit they differ from that one in.
+typedef struct s_radix {
+  uint64_t* apui64Key[RADIX_BUCKETS];
+  ll*       apllVal[RADIX_BUCKETS];
+  ll        allSize[RADIX_BUCKETS];
+  ll        allMax[RADIX_BUCKETS];
+  uint64_t  ui64Last;  // Last popped key.
+  ll        llCount;   // Entries in all buckets.
+} t_radix;
+
+// Way through a maze and the solver's scratch, which is kept between solves.
+// Searches from both ends use index 1 for the end, else only index 0.
+typedef struct s_path {
+  char*     pcDirs;           // Steps as g_dChar characters, 0 terminated.
+  ll        llLength;         // Steps in pcDirs, -1 if there is no way.
+  ll        llExpanded;       // Cells taken from the frontier by the last solve.
+  ll        llDirsSize;       // Bytes allocated for pcDirs.
+  uint64_t* apui64Seen[2];    // 1 bit per grid cell.
+  ll        allSeenLo[2];     // Lowest and highest word set in apui64Seen.
+  ll        allSeenHi[2];
+  uint8_t*  apui8From[2];     // Direction each cell was entered from, 2 bits.
+  ll*       apllQueue[2];     // Frontiers as ring buffers.
+  ll        allQueueSize[2];  // Slots of the rings, a power of 2.
+  t_radix   tOpen;            // Open list of A*.
+  t_board   tFill;            // Walls and filled cells of the dead end filler.
+  ll        llGridCount;      // Grid the scratch was allocated for.
+} t_path;
+
+// Shared state of the dead end filler threads, each takes bands of rows.
+typedef struct s_fill {
+  t_board* ptBoard;
+  int      iBands;
+  int      iNext;     // Next band to fill.
+  int      bChanged;  // Any cell filled in this round.
+  ll       allKeep[2];          // Words of the ends, never filled ...
+  uint64_t aui64Keep[2];        // ... and their bits.
+} t_fill;
+
+// Index of the maze as a tree rooted at the exit. Cells are numbered in
+// preorder, so the cells between two numbers hold the way from one to the
+// other, its top is the one with the least depth.
+typedef struct s_tree {
+  ll        llCount;     // Cells in the tree.
+  ll        llBlocks;    // Blocks of TREE_BLOCK preorder numbers.
+  int       iLevels;     // Levels of the sparse table.
+  uint32_t* pui32Pre;    // Preorder number of each grid cell.
+  uint32_t* pui32Cell;   // Grid cell of each preorder number.
+  uint32_t* pui32Depth;  // Steps to the exit of each preorder number.
+  uint32_t* pui32Mask;   // Minima from the block's start, see treeMin().
+  uint32_t* pui32Table;  // Sparse table of block minima, iLevels * llBlocks.
+  uint8_t*  pui8Up;      // Direction towards the exit per grid cell, 2 bits.
+} t_tree;
+
+// Maze contracted to junctions, dead ends and the exit as nodes, joined by
+// the corridors in between. Edges are stored per node (CSR), each corridor
+// once in each direction.
+typedef struct s_graph {
+  ll        llNodes;
+  ll        llEdges;
+  uint32_t* pui32Node;   // Node of each grid cell, GRAPH_NONE in corridors.
+  uint32_t* pui32Cell;   // Grid cell of each node.
+  uint32_t* pui32First;  // Edges of node n are First[n] to First[n + 1] - 1.
+  uint32_t* pui32To;     // Node at the other end of the edge.
+  uint32_t* pui32Len;    // Steps from node to node.
+  ll*       pllDirs;     // First of the edge's steps in pui8Dirs.
+  uint8_t*  pui8Dirs;    // Steps of all corridors, 2 bits each.
+} t_graph;
+
+// Steps from each grid cell to the exit, 16 bits per cell if the maze is
+// small enough, else 32 bits. Only one of the arrays is used.
+typedef struct s_dist {
+  int       iBits;
+  uint16_t* pui16Dist;
+  uint32_t* pui32Dist;
+} t_dist;
+
+// Shared state of the distance threads, each takes chunks of edges.
+typedef struct s_distfill {
+  t_maze*  ptMaze;
+  t_graph* ptGraph;
+  t_dist*  ptDist;
+  ll*      pllDist;  // Steps of each node.
+  ll       llNext;   // Next chunk of edges.
+} t_distfill;
+
+// Shared state of the batch worker threads.
+typedef struct s_batch {
+  FILE*           hOut;      // Export file or NULL.
+  int             iNext;     // Next maze to generate.
+  int             iWritten;  // Mazes exported so far, keeps the file in order.
+  int             bFailed;   // A worker got no memory.
+  pthread_mutex_t tMutex;
+  pthread_cond_t  tCond;
+} t_batch;
+
 s_array(cstr);
 
 
@@ -107,8 +472,7 @@ s_array(cstr);
 // Arguments
 t_options     g_tOpts;  // CLI options and arguments.
 t_array(cstr) g_tArgs;  // Free arguments.
-t_grid        g_tMaze;  // The maze's grid.
-t_stack       g_tStack; // Stack for back-propagating during maze's creation.
+t_view        g_tView;  // Templates of the first person view.
 
 
 //******************************************************************************
@@ -127,17 +491,66 @@ void usage(int iErr, const char* pcMsg) {
 
   csSetf(&csMsg, "%s"
 //|************************ 80 chars width ****************************************|
-   "usage: %s [-w n] [-h n]\n"
+   "usage: %s [-w n] [-h n] [-L] [-o file] [--seed n] [--algo name] [-t n]\n"
+   "          [--no-animate]\n"
+   "       %s [-w n] [-h n] [-L] [-o file] [--seed n] [--algo name] [-t n]\n"
+   "          --count n\n"
+   "       %s [-w n] [-h n] [-L] [-o file] [--seed n] [--algo name] [-t n]\n"
+   "          --solve --stats --solver name --braid P --dist\n"
+   "       %s [-w n] [-h n] [-L] [--seed n] [--algo name] [-t n] --bench\n"
    "       %s [--help|-v|--version]\n"
    " Creates a maze with pseudo 3D look.\n"
-   " You can walk with the ijkl or wasd keys.\n"
+   " You can walk with the ijkl or wasd keys, 'h' shows the way to the exit.\n"
    "  -w n:          width of maze's grid (default 20)\n"
    "  -h n:          height of maze's grid (default 10)\n"
+   "  -L|--large:    use 2 bits per cell, implied above 100 cells per side\n"
+   "  -o file:       write maze to file ('-' is stdout) instead of playing\n"
+   "  --seed n:      seed for the random generator, same seed gives same maze\n"
+   "  --no-animate:  don't show the maze while it is generated\n"
+   "  --count n:     generate n mazes without playing, print mazes/s to stderr,\n"
+   "                 maze i of a batch uses seed + i\n"
+   "  --algo name:   generator, one of:\n"
+   "                   backtrack  recursive backtracker (default)\n"
+   "                   tiles      backtracker per tile on all threads, joined\n"
+   "                   eller      row by row, streams to '-o' with constant\n"
+   "                              memory, height up to 2^31 - 1\n"
+   "                   kruskal    random walls joining sets, shuffled on all\n"
+   "                              threads, up to 2^31 - 1 cells\n"
+   "                   wilson     loop erased random walks, every maze is\n"
+   "                              equally likely\n"
+   "                   binary     each cell opens south or east, fastest\n"
+   "                   sidewinder runs to the east with one way south each\n"
+   "                   growing    growing tree, cells picked by '--policy'\n"
+   "  --policy name: cell the growing tree goes on from, one of:\n"
+   "                   newest     last added, like backtrack (default)\n"
+   "                   random     any, like Prim's algorithm\n"
+   "                   oldest     first added, long straight corridors\n"
+   "                   mix:P      random in P percent of picks, else newest\n"
+   "  -t|--threads n: threads for '--count', the 'tiles' and 'kruskal'\n"
+   "                 generators and the 'deadend' solver\n"
+   "                 (default 1)\n"
+   "  --solve:       print the shortest way from the start to the exit to\n"
+   "                 stdout, after the maze if '-o' is stdout, cells expanded\n"
+   "                 per second to stderr\n"
+   "  --solver name: search used by '--solve', one of:\n"
+   "                   bfs        breadth first (default)\n"
+   "                   astar      A* towards the exit\n"
+   "                   bidir      breadth first from both ends\n"
+   "                   deadend    fills all dead ends, row bands on '-t'\n"
+   "                              threads\n"
+   "  --braid P:     open P percent of the dead ends after generation, the\n"
+   "                 maze gets loops\n"
+   "  --dist:        write the steps from each cell to the exit to\n"
+   "                 '<file>.dist', needs '-o file'\n"
+   "  --stats:       print junctions, dead ends and corridors of the maze to\n"
+   "                 stdout\n"
+   "  --bench:       measure generation and render speed (results to stderr)\n"
    "  --help:        print this help\n"
    "  -v|--version:  print version of program\n"
 //|************************ 80 chars width ****************************************|
          ,csMsg.cStr,
-         g_csMename.cStr, g_csMename.cStr
+         g_csMename.cStr, g_csMename.cStr, g_csMename.cStr, g_csMename.cStr,
+         g_csMename.cStr
         );
 
   if (iErr == ERR_NOERR)
@@ -170,6 +583,15 @@ void dispatchError(int rv, const char* pcMsg) {
   usage(rv, csErr.cStr);
 }
 
+/*******************************************************************************
+ * Name:  isStreamed
+ * Purpose: True if the maze goes straight from the generator into the file.
+ *******************************************************************************/
+int isStreamed(void) {
+  return g_tOpts.iAlgo == ALGO_ELLER && g_tOpts.csOut.len != 0 &&
+         g_tOpts.iCount == 0 && ! g_tOpts.bBench;
+}
+
 /*******************************************************************************
  * Name:  getOptions
  * Purpose: Filters command line.
@@ -178,6 +600,7 @@ void getOptions(int argc, char* argv[]) {
   cstr csArgv = csNew("");
   cstr csRv   = csNew("");
   cstr csOpt  = csNew("");
+  cstr csAlgo = csNew("");
   int  iArg   = 1;  // Omit program name in arg loop.
   int  iChar  = 0;
   char cOpt   = 0;
@@ -185,6 +608,16 @@ void getOptions(int argc, char* argv[]) {
   // Set defaults.
   g_tOpts.iMazeW = 20;
   g_tOpts.iMazeH = 10;
+  g_tOpts.bBench = 0;
+  g_tOpts.bLarge = 0;
+  g_tOpts.csOut  = csNew("");
+  g_tOpts.llSeed   = (ll) time(NULL);
+  g_tOpts.bAnimate = 1;
+  g_tOpts.iCount   = 0;
+  g_tOpts.iThreads = 1;
+  g_tOpts.iAlgo    = ALGO_BACKTRACK;
+  g_tOpts.iPolicy  = POLICY_NEWEST;
+  g_tOpts.iMix     = 0;
 
   // Init free argument's dynamic array.
   daInit(cstr, g_tArgs);
@@ -204,6 +637,81 @@ next_argument:
       if (!strcmp(csArgv.cStr, "--version")) {
         version();
       }
+      if (!strcmp(csArgv.cStr, "--large")) {
+        g_tOpts.bLarge = 1;
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--seed")) {
+        if (! getArgLong(&g_tOpts.llSeed, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "No valid seed or missing");
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--no-animate")) {
+        g_tOpts.bAnimate = 0;
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--count")) {
+        if (! getArgInt(&g_tOpts.iCount, &iArg, argc, argv, ARG_CLI, NULL) || g_tOpts.iCount < 1)
+          dispatchError(ERR_ARGS, "No valid count or missing");
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--algo")) {
+        if (! getArgStr(&csAlgo, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "No generator name or missing");
+        for (g_tOpts.iAlgo = 0; g_tOpts.iAlgo < ALGO_COUNT; ++g_tOpts.iAlgo)
+          if (!strcmp(csAlgo.cStr, g_acAlgo[g_tOpts.iAlgo])) break;
+        if (g_tOpts.iAlgo == ALGO_COUNT)
+          dispatchError(ERR_ARGS, "Unknown generator");
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--policy")) {
+        if (! getArgStr(&csAlgo, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "No policy name or missing");
+        for (g_tOpts.iPolicy = 0; g_tOpts.iPolicy < POLICY_MIX; ++g_tOpts.iPolicy)
+          if (!strcmp(csAlgo.cStr, g_acPolicy[g_tOpts.iPolicy])) break;
+        if (g_tOpts.iPolicy == POLICY_MIX) {
+          if (strncmp(csAlgo.cStr, "mix:", 4) || sscanf(csAlgo.cStr + 4, "%d", &g_tOpts.iMix) != 1 ||
+              g_tOpts.iMix < 0 || g_tOpts.iMix > 100)
+            dispatchError(ERR_ARGS, "Unknown policy");
+        }
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--threads")) {
+        if (! getArgInt(&g_tOpts.iThreads, &iArg, argc, argv, ARG_CLI, NULL) || g_tOpts.iThreads < 1)
+          dispatchError(ERR_ARGS, "No valid thread count or missing");
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--solve")) {
+        g_tOpts.bSolve = 1;
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--solver")) {
+        if (! getArgStr(&csAlgo, &iArg, argc, argv, ARG_CLI, NULL))
+          dispatchError(ERR_ARGS, "No solver name or missing");
+        for (g_tOpts.iSolver = 0; g_tOpts.iSolver < SOLVER_COUNT; ++g_tOpts.iSolver)
+          if (!strcmp(csAlgo.cStr, g_acSolver[g_tOpts.iSolver])) break;
+        if (g_tOpts.iSolver == SOLVER_COUNT)
+          dispatchError(ERR_ARGS, "Unknown solver");
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--braid")) {
+        if (! getArgInt(&g_tOpts.iBraid, &iArg, argc, argv, ARG_CLI, NULL) ||
+            g_tOpts.iBraid < 0 || g_tOpts.iBraid > 100)
+          dispatchError(ERR_ARGS, "No valid braid percentage or missing");
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--dist")) {
+        g_tOpts.bDist = 1;
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--stats")) {
+        g_tOpts.bStats = 1;
+        continue;
+      }
+      if (!strcmp(csArgv.cStr, "--bench")) {
+        g_tOpts.bBench = 1;
+        continue;
+      }
       dispatchError(ERR_ARGS, "Invalid long option");
     }
 
@@ -224,6 +732,20 @@ next_argument:
             dispatchError(ERR_ARGS, "No valid height or missing");
           continue;
         }
+        if (cOpt == 'L') {
+          g_tOpts.bLarge = 1;
+          continue;
+        }
+        if (cOpt == 't') {
+          if (! getArgInt(&g_tOpts.iThreads, &iArg, argc, argv, ARG_CLI, NULL) || g_tOpts.iThreads < 1)
+            dispatchError(ERR_ARGS, "No valid thread count or missing");
+          continue;
+        }
+        if (cOpt == 'o') {
+          if (! getArgStr(&g_tOpts.csOut, &iArg, argc, argv, ARG_CLI, NULL))
+            dispatchError(ERR_ARGS, "No valid file name or missing");
+          continue;
+        }
         dispatchError(ERR_ARGS, "Invalid short option");
       }
       goto next_argument;
@@ -235,30 +757,40 @@ next_argument:
   // Sanity check of arguments and flags.
   if (g_tArgs.sCount != 0) dispatchError(ERR_ARGS, "No file needed");
 
-  if (g_tOpts.iMazeW < 0 || g_tOpts.iMazeW > GRID_MAX)
+  // Mazes bigger than the wall byte grid need the large mode.
+  if (g_tOpts.iMazeW > GRID_MAX || g_tOpts.iMazeH > GRID_MAX)
+    g_tOpts.bLarge = 1;
+
+  // Only an interactive game shows the generation, watching large mazes grow
+  // would take forever.
+  if (g_tOpts.bLarge || g_tOpts.iCount != 0 || g_tOpts.csOut.len != 0 || g_tOpts.bSolve ||
+      g_tOpts.bStats)
+    g_tOpts.bAnimate = 0;
+
+  if (g_tOpts.iMazeW < 1 || g_tOpts.iMazeW > GRID_MAX_LARGE)
     dispatchError(ERR_ARGS, "x dimension out of bounds");
-  if (g_tOpts.iMazeH < 0 || g_tOpts.iMazeH > GRID_MAX)
+  // Streamed mazes have no grid, only the width counts.
+  if (g_tOpts.iMazeH < 1 || (g_tOpts.iMazeH > GRID_MAX_LARGE && ! isStreamed()))
     dispatchError(ERR_ARGS, "y dimension out of bounds");
 
-  // Set grid values.
-  g_tMaze.iMazeW     = g_tOpts.iMazeW;
-  g_tMaze.iMazeH     = g_tOpts.iMazeH;
-  g_tMaze.iGridW     = g_tOpts.iMazeW + 2;
-  g_tMaze.iGridH     = g_tOpts.iMazeH + 2;
-  g_tMaze.iMazeCount = g_tMaze.iMazeW * g_tMaze.iMazeH;
-  g_tMaze.iGridCount = g_tMaze.iGridW * g_tMaze.iGridH;
+  if ((g_tOpts.bSolve || g_tOpts.bStats) && (g_tOpts.iCount != 0 || isStreamed()))
+    dispatchError(ERR_ARGS, "Only a single maze in memory can be solved");
 
-  // Grid and max stack. Grid will have a border with special value.
-  g_tStack.piCell = (int*) malloc(g_tMaze.iMazeCount * sizeof(int));
-  g_tMaze.piCells = (int*) malloc(g_tMaze.iGridCount * sizeof(int));
+  if (g_tOpts.bDist && (g_tOpts.csOut.len == 0 || ! strcmp(g_tOpts.csOut.cStr, "-") ||
+                        g_tOpts.iCount != 0 || isStreamed()))
+    dispatchError(ERR_ARGS, "Distances need a single maze in memory and '-o file'");
 
-  // Init stack pointer.
-  g_tStack.sStackSize = STACK_EMPTY;
+  if (g_tOpts.iBraid != 0 && isStreamed())
+    dispatchError(ERR_ARGS, "Streamed mazes can't be braided");
+
+  if (g_tOpts.iAlgo == ALGO_KRUSKAL && (ll) g_tOpts.iMazeW * g_tOpts.iMazeH > KRUSKAL_MAX)
+    dispatchError(ERR_ARGS, "Maze too big for kruskal");
 
   // Free string memory.
   csFree(&csArgv);
   csFree(&csRv);
   csFree(&csOpt);
+  csFree(&csAlgo);
 }
 
 /*******************************************************************************
@@ -281,70 +813,220 @@ int getch(void) {
 }
 
 /*******************************************************************************
- * Name:  initRand
- * Purpose: Initialise random generator with current time.
+ * Name:  getSeconds
+ * Purpose: Returns a monotonic time stamp in seconds.
+ *******************************************************************************/
+double getSeconds(void) {
+  struct timespec tTime = {0};
+  clock_gettime(CLOCK_MONOTONIC, &tTime);
+  return (double) tTime.tv_sec + (double) tTime.tv_nsec * 1e-9;
+}
+
+/*******************************************************************************
+ * Name:  getFreeMemory
+ * Purpose: Returns the bytes of physical memory not in use, -1 if unknown.
+ *******************************************************************************/
+ll getFreeMemory(void) {
+  long lPages = sysconf(_SC_AVPHYS_PAGES);
+  long lSize  = sysconf(_SC_PAGESIZE);
+
+  if (lPages < 0 || lSize < 0) return -1;
+  return (ll) lPages * lSize;
+}
+
+/*******************************************************************************
+ * Name:  randSeed
+ * Purpose: Initialises a random generator's state from a seed via splitmix64.
+ *******************************************************************************/
+void randSeed(t_rand* ptRand, uint64_t ui64Seed) {
+  uint64_t z = 0;
+
+  for (int i = 0; i < 4; ++i) {
+    z  = (ui64Seed += 0x9e3779b97f4a7c15ULL);
+    z  = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z  = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    ptRand->aui64State[i] = z ^ (z >> 31);
+  }
+
+  ptRand->iBufPos   = RAND_BUF_SIZE;
+  ptRand->ui64Bits  = 0;
+  ptRand->iBitsLeft = 0;
+}
+
+/*******************************************************************************
+ * Name:  randFill
+ * Purpose: Refills the whole word buffer with xoshiro256**.
+ *******************************************************************************/
+void randFill(t_rand* ptRand) {
+  uint64_t* s = ptRand->aui64State;
+  uint64_t  t = 0;
+
+  for (int i = 0; i < RAND_BUF_SIZE; ++i) {
+    ptRand->aui64Buf[i] = s[1] * 5;
+    ptRand->aui64Buf[i] = ((ptRand->aui64Buf[i] << 7) | (ptRand->aui64Buf[i] >> 57)) * 9;
+    t     = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3]  = (s[3] << 45) | (s[3] >> 19);
+  }
+
+  ptRand->iBufPos = 0;
+}
+
+/*******************************************************************************
+ * Name:  randU64
+ * Purpose: Returns the next 64 random bits.
  *******************************************************************************/
-void initRand(void) {
-  time_t t;
-  srand((unsigned) time(&t));
+uint64_t randU64(t_rand* ptRand) {
+  if (ptRand->iBufPos == RAND_BUF_SIZE) randFill(ptRand);
+  return ptRand->aui64Buf[ptRand->iBufPos++];
 }
 
 /*******************************************************************************
- * Name:  randF
- * Purpose: Generates a random float between 0 and 0.99.
+ * Name:  randBits
+ * Purpose: Returns iCount (1 - 32) random bits from the reservoir.
  *******************************************************************************/
-float randF(void) {
-  return (float) rand() / (float) RAND_MAX;
+int randBits(t_rand* ptRand, int iCount) {
+  int iRv = 0;
+
+  if (ptRand->iBitsLeft < iCount) {
+    ptRand->ui64Bits  = randU64(ptRand);
+    ptRand->iBitsLeft = 64;
+  }
+
+  iRv = (int) (ptRand->ui64Bits & ((1ULL << iCount) - 1));
+  ptRand->ui64Bits  >>= iCount;
+  ptRand->iBitsLeft  -= iCount;
+
+  return iRv;
 }
 
 /*******************************************************************************
  * Name:  randI
- * Purpose: Generates an int between 0 and iTo (exclusive).
+ * Purpose: Generates an integer between 0 and llTo (exclusive).
  *******************************************************************************/
-int randI(int iTo) {
-  return randF() * (float) iTo;
+ll randI(t_rand* ptRand, ll llTo) {
+  // Multiply-shift instead of modulo, the bias is below 2^-32 for all sizes.
+  return (ll) (((__uint128_t) randU64(ptRand) * (uint64_t) llTo) >> 64);
 }
 
 /*******************************************************************************
  * Name:  randIab
- * Purpose: Generates an int between a and b (exclusive).
+ * Purpose: Generates an integer between a and b (exclusive).
+ *******************************************************************************/
+ll randIab(t_rand* ptRand, ll a, ll b) {
+  return randI(ptRand, b - a) + a;
+}
+
+/*******************************************************************************
+ * Name:  mazeFree
+ * Purpose: Frees all memory of a maze context.
+ *******************************************************************************/
+void mazeFree(t_maze* ptMaze) {
+  free(ptMaze->pui8Cells);
+  free(ptMaze->pui64Packed);
+  free(ptMaze->tFrame.pcBuf);
+  ptMaze->pui8Cells    = NULL;
+  ptMaze->pui64Packed  = NULL;
+  ptMaze->tFrame.pcBuf = NULL;
+  ptMaze->tFrame.sSize = 0;
+}
+
+/*******************************************************************************
+ * Name:  mazeReseed
+ * Purpose: Restarts a maze's random generator with a new seed.
+ *******************************************************************************/
+void mazeReseed(t_maze* ptMaze, ll llSeed) {
+  ptMaze->llSeed = llSeed;
+  randSeed(&ptMaze->tRand, (uint64_t) llSeed);
+}
+
+/*******************************************************************************
+ * Name:  mazeInit
+ * Purpose: Sets up a maze context and allocates its grid, the generators
+ *          allocate what else they need. Returns 0 if there is not enough
+ *          memory, nothing stays allocated then.
  *******************************************************************************/
-int randIab(int a, int b) {
-  return randF() * (float) (b - a) + a;
+int mazeInit(t_maze* ptMaze, int iMazeW, int iMazeH, int bLarge, ll llSeed) {
+  memset(ptMaze, 0, sizeof(t_maze));
+
+  // Backtracker on one thread by default.
+  ptMaze->iAlgo    = ALGO_BACKTRACK;
+  ptMaze->iPolicy  = POLICY_NEWEST;
+  ptMaze->iThreads = 1;
+
+  // Set grid values.
+  ptMaze->iMazeW      = iMazeW;
+  ptMaze->iMazeH      = iMazeH;
+  ptMaze->iGridW      = iMazeW + 2;
+  ptMaze->iGridH      = iMazeH + 2;
+  ptMaze->llMazeCount = (ll) ptMaze->iMazeW * ptMaze->iMazeH;
+  ptMaze->llGridCount = (ll) ptMaze->iGridW * ptMaze->iGridH;
+  ptMaze->bLarge      = bLarge;
+
+  // Grid will have a border with special value.
+  if (ptMaze->bLarge)
+    ptMaze->pui64Packed = (uint64_t*) malloc(((ptMaze->llGridCount >> PACK_SHIFT) + 1) * sizeof(uint64_t));
+  else
+    ptMaze->pui8Cells = (uint8_t*) malloc(ptMaze->llGridCount * sizeof(uint8_t));
+
+  // Init stack pointer.
+  ptMaze->tStack.llSize    = STACK_EMPTY;
+  ptMaze->tStack.llMaxSize = STACK_EMPTY;
+
+  // Every maze has its own random sequence.
+  mazeReseed(ptMaze, llSeed);
+
+  if (ptMaze->pui8Cells == NULL && ptMaze->pui64Packed == NULL) {
+    mazeFree(ptMaze);
+    return 0;
+  }
+  return 1;
 }
 
 /*******************************************************************************
  * Name:  xy2cell
  * Purpose: Calculates the cell offset from given X and Y coordinates.
  *******************************************************************************/
-int xy2cell(int iX, int iY) {
-  return iX + iY * g_tMaze.iGridW;
+ll xy2cell(t_maze* ptMaze, ll llX, ll llY) {
+  return llX + llY * ptMaze->iGridW;
 }
 
 /*******************************************************************************
  * Name:  cell2xy
  * Purpose: Converts a cell index into x and y coordinates.
  *******************************************************************************/
-void cell2xy(int iCell, int* piX, int* piY) {
-  *piX = iCell % g_tMaze.iGridW;
-  *piY = iCell / g_tMaze.iGridW;
+void cell2xy(t_maze* ptMaze, ll llCell, int* piX, int* piY) {
+  *piX = (int) (llCell % ptMaze->iGridW);
+  *piY = (int) (llCell / ptMaze->iGridW);
 }
 
 /*******************************************************************************
- * Name:  pullCell
- * Purpose: Pulls value from stack.
+ * Name:  pullDir
+ * Purpose: Pulls the last direction taken from stack, -1 if it is empty.
  *******************************************************************************/
-int pullCell(void) {
-  if (g_tStack.sStackSize == STACK_EMPTY) return -1;
-  return g_tStack.piCell[--g_tStack.sStackSize];
+int pullDir(t_maze* ptMaze) {
+  ll llPos = 0;
+
+  if (ptMaze->tStack.llSize == STACK_EMPTY) return -1;
+  llPos = --ptMaze->tStack.llSize;
+  return (ptMaze->tStack.pui8Dir[llPos >> 2] >> ((llPos & 3) << 1)) & 3;
 }
 
 /*******************************************************************************
- * Name:  pushCell
- * Purpose: Pushes value onto stack.
+ * Name:  pushDir
+ * Purpose: Pushes the direction of a step onto stack.
  *******************************************************************************/
-void pushCell(int iCell) {
-  g_tStack.piCell[g_tStack.sStackSize++] = iCell;
+void pushDir(t_maze* ptMaze, int iDir) {
+  ll  llPos  = ptMaze->tStack.llSize++;
+  int iShift = (llPos & 3) << 1;
+
+  ptMaze->tStack.pui8Dir[llPos >> 2] = (ptMaze->tStack.pui8Dir[llPos >> 2] & ~(3 << iShift)) | iDir << iShift;
+  if (ptMaze->tStack.llSize > ptMaze->tStack.llMaxSize)
+    ptMaze->tStack.llMaxSize = ptMaze->tStack.llSize;
 }
 
 /*******************************************************************************
@@ -371,107 +1053,296 @@ int turnRight(int iDir) {
   return (iDir + 3) % DIR_MOD;
 }
 
+/*******************************************************************************
+ * Name:  getDirWall
+ * Purpose: Returns wall bit in direction.
+ *******************************************************************************/
+int getDirWall(int iDir) {
+  return 1 << iDir;
+}
+
+/*******************************************************************************
+ * Name:  getPacked
+ * Purpose: Returns the south and east wall bits of a cell in large mode.
+ *******************************************************************************/
+int getPacked(t_maze* ptMaze, ll llCell) {
+  // Relaxed load is a plain load, but stays well defined while tiles are carved.
+  uint64_t ui64Word = __atomic_load_n(&ptMaze->pui64Packed[llCell >> PACK_SHIFT], __ATOMIC_RELAXED);
+  return (ui64Word >> ((llCell & PACK_MASK) << 1)) & PACK_BOTH;
+}
+
+/*******************************************************************************
+ * Name:  clearPacked
+ * Purpose: Clears south and/or east wall bits of a cell in large mode.
+ *******************************************************************************/
+void clearPacked(t_maze* ptMaze, ll llCell, int iBits) {
+  uint64_t ui64Mask = ~((uint64_t) iBits << ((llCell & PACK_MASK) << 1));
+
+  // Neighbouring tiles share words at their left and right edges.
+  if (ptMaze->bShared)
+    __atomic_fetch_and(&ptMaze->pui64Packed[llCell >> PACK_SHIFT], ui64Mask, __ATOMIC_RELAXED);
+  else
+    ptMaze->pui64Packed[llCell >> PACK_SHIFT] &= ui64Mask;
+}
+
+/*******************************************************************************
+ * Name:  getCellWalls
+ * Purpose: Returns all walls of a (non border) cell as CELL_* bits.
+ *******************************************************************************/
+int getCellWalls(t_maze* ptMaze, ll llCell) {
+  int iWalls = 0;
+
+  if (! ptMaze->bLarge) return ptMaze->pui8Cells[llCell];
+
+  // Own walls first, north and west walls belong to the neighbours.
+  iWalls = getPacked(ptMaze, llCell);
+  iWalls = ((iWalls & PACK_SOUTH) ? CELL_SOUTH : 0) | ((iWalls & PACK_EAST) ? CELL_EAST : 0);
+  if (getPacked(ptMaze, llCell - ptMaze->iGridW) & PACK_SOUTH) iWalls |= CELL_NORTH;
+  if (getPacked(ptMaze, llCell - 1)              & PACK_EAST)  iWalls |= CELL_WEST;
+
+  return iWalls;
+}
+
+/*******************************************************************************
+ * Name:  isCellWhole
+ * Purpose: Returns true if the cell still has all its walls.
+ *******************************************************************************/
+int isCellWhole(t_maze* ptMaze, ll llCell) {
+  // A border cell never equals CELL_WHOLE, so no extra border check is needed.
+  if (! ptMaze->bLarge) return ptMaze->pui8Cells[llCell] == CELL_WHOLE;
+
+  // Check own bits first, a border cell fails here before any neighbour read.
+  if (getPacked(ptMaze, llCell) != PACK_BOTH)                       return 0;
+  if (! (getPacked(ptMaze, llCell - ptMaze->iGridW) & PACK_SOUTH)) return 0;
+  if (! (getPacked(ptMaze, llCell - 1)              & PACK_EAST))  return 0;
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  goToCell
+ * Purpose: Just go to cell in direction.
+ *******************************************************************************/
+void goToCell(t_maze* ptMaze, int iDir, ll* pllCell) {
+  if (iDir == DIR_NORTH) *pllCell -= ptMaze->iGridW;
+  if (iDir == DIR_WEST)  *pllCell -= 1;
+  if (iDir == DIR_SOUTH) *pllCell += ptMaze->iGridW;
+  if (iDir == DIR_EAST)  *pllCell += 1;
+}
+
 /*******************************************************************************
  * Name:  getCellInDir
- * Purpose: Returns content of next cell in direction iDir.
+ * Purpose: Returns index of next cell in direction iDir.
  *******************************************************************************/
-int getCellInDir(int iDir, int iCell) {
-  if (iDir == DIR_NORTH) return g_tMaze.piCells[iCell - g_tMaze.iGridW];
-  if (iDir == DIR_WEST)  return g_tMaze.piCells[iCell - 1];
-  if (iDir == DIR_SOUTH) return g_tMaze.piCells[iCell + g_tMaze.iGridW];
-  if (iDir == DIR_EAST)  return g_tMaze.piCells[iCell + 1];
-  return -1;
+ll getCellInDir(t_maze* ptMaze, int iDir, ll llCell) {
+  goToCell(ptMaze, iDir, &llCell);
+  return llCell;
 }
 
 /*******************************************************************************
  * Name:  isBorder
  * Purpose: Returns true if iDir points beyond cells.
  *******************************************************************************/
-int isBorder(int iDir, int iCell) {
-  if (getCellInDir(iDir, iCell) == CELL_BORDER) return 1;
-  return 0;
+int isBorder(t_maze* ptMaze, int iDir, ll llCell) {
+  int iX = 0;
+  int iY = 0;
+
+  llCell = getCellInDir(ptMaze, iDir, llCell);
+
+  if (! ptMaze->bLarge) return ptMaze->pui8Cells[llCell] == CELL_BORDER;
+
+  cell2xy(ptMaze, llCell, &iX, &iY);
+  return iX == 0 || iY == 0 || iX == ptMaze->iGridW - 1 || iY == ptMaze->iGridH - 1;
 }
 
 /*******************************************************************************
  * Name:  isWallInDir
  * Purpose: Returns true if iDir points to a wall.
  *******************************************************************************/
-int isWallInDir(int iDir, int iCell) {
-  iCell = g_tMaze.piCells[iCell];
-  if (iDir == DIR_NORTH && iCell % CELL_NORTH != 0) return 0;
-  if (iDir == DIR_WEST  && iCell % CELL_WEST  != 0) return 0;
-  if (iDir == DIR_SOUTH && iCell % CELL_SOUTH != 0) return 0;
-  if (iDir == DIR_EAST  && iCell % CELL_EAST  != 0) return 0;
-  return 1;
+int isWallInDir(t_maze* ptMaze, int iDir, ll llCell) {
+  if (! ptMaze->bLarge) return (ptMaze->pui8Cells[llCell] & getDirWall(iDir)) != 0;
+
+  // Only one packed read needed per wall.
+  if (iDir == DIR_NORTH) return (getPacked(ptMaze, llCell - ptMaze->iGridW) & PACK_SOUTH) != 0;
+  if (iDir == DIR_WEST)  return (getPacked(ptMaze, llCell - 1)              & PACK_EAST)  != 0;
+  if (iDir == DIR_SOUTH) return (getPacked(ptMaze, llCell)                  & PACK_SOUTH) != 0;
+  return (getPacked(ptMaze, llCell) & PACK_EAST) != 0;
 }
 
 /*******************************************************************************
  * Name:  isDirCellWhole
  * Purpose: Returns true if next cell in iDir is whole.
  *******************************************************************************/
-int isDirCellWhole(int iDir, int iCell) {
-  if (isBorder(iDir, iCell))                   return 0;
-  if (getCellInDir(iDir, iCell) == CELL_WHOLE) return 1;
-  return 0;
+int isDirCellWhole(t_maze* ptMaze, int iDir, ll llCell) {
+  return isCellWhole(ptMaze, getCellInDir(ptMaze, iDir, llCell));
 }
 
 /*******************************************************************************
- * Name:  getDirWall
- * Purpose: Returns wall in direction.
+ * Name:  breakWall
+ * Purpose: Breaks the wall between a cell and its neighbour in direction.
  *******************************************************************************/
-int getDirWall(int iDir) {
-  if (iDir == DIR_NORTH) return CELL_NORTH;
-  if (iDir == DIR_WEST)  return CELL_WEST;
-  if (iDir == DIR_SOUTH) return CELL_SOUTH;
-  if (iDir == DIR_EAST)  return CELL_EAST;
-  return CELL_NONE;
+void breakWall(t_maze* ptMaze, int iDir, ll llCell) {
+  if (ptMaze->bLarge) {
+    if (iDir == DIR_NORTH) clearPacked(ptMaze, llCell - ptMaze->iGridW, PACK_SOUTH);
+    if (iDir == DIR_WEST)  clearPacked(ptMaze, llCell - 1,              PACK_EAST);
+    if (iDir == DIR_SOUTH) clearPacked(ptMaze, llCell,                  PACK_SOUTH);
+    if (iDir == DIR_EAST)  clearPacked(ptMaze, llCell,                  PACK_EAST);
+    return;
+  }
+
+  // Border cells carry no wall bits, so breaking the exit leaves them intact.
+  ptMaze->pui8Cells[llCell] &= ~getDirWall(iDir);
+  ptMaze->pui8Cells[getCellInDir(ptMaze, iDir, llCell)] &= ~getDirWall(turnBack(iDir));
 }
 
 /*******************************************************************************
- * Name:  goToCell
- * Purpose: Just go to cell in direction.
+ * Name:  getAround
+ * Purpose: Returns the whole neighbours of a cell as CELL_* bits.
+ *******************************************************************************/
+int getAround(t_maze* ptMaze, ll llCell) {
+  return (ptMaze->pui8Around[llCell >> 1] >> ((llCell & 1) << 2)) & CELL_WHOLE;
+}
+
+/*******************************************************************************
+ * Name:  clearAround
+ * Purpose: Removes a neighbour from the whole neighbours of a cell.
+ *******************************************************************************/
+void clearAround(t_maze* ptMaze, ll llCell, int iWall) {
+  ptMaze->pui8Around[llCell >> 1] &= ~(iWall << ((llCell & 1) << 2));
+}
+
+/*******************************************************************************
+ * Name:  markBroken
+ * Purpose: Tells the neighbours of a cell that it isn't whole anymore.
+ *******************************************************************************/
+void markBroken(t_maze* ptMaze, ll llCell) {
+  if (! ptMaze->bAround) return;
+  clearAround(ptMaze, llCell - ptMaze->iGridW, CELL_SOUTH);
+  clearAround(ptMaze, llCell + ptMaze->iGridW, CELL_NORTH);
+  clearAround(ptMaze, llCell - 1,              CELL_EAST);
+  clearAround(ptMaze, llCell + 1,              CELL_WEST);
+}
+
+/*******************************************************************************
+ * Name:  initAround
+ * Purpose: Allocates the masks and sets the whole neighbours of all cells,
+ *          the exit isn't whole. Masks that don't fit into free memory are
+ *          left out, the neighbours are probed then.
+ *******************************************************************************/
+void initAround(t_maze* ptMaze) {
+  ll  llSize = (ptMaze->llGridCount >> 1) + 1;
+  ll  llFree = getFreeMemory();
+  ll  llCell = 0;
+  int iBits  = 0;
+
+  ptMaze->bAround = 0;
+  if (llFree != -1 && llSize > llFree) return;
+  if ((ptMaze->pui8Around = (uint8_t*) calloc(llSize, sizeof(uint8_t))) == NULL) return;
+
+  for (int y = 1; y < ptMaze->iMazeH + 1; ++y) {
+    llCell = xy2cell(ptMaze, 1, y);
+    for (int x = 1; x < ptMaze->iMazeW + 1; ++x, ++llCell) {
+      iBits = CELL_WHOLE;
+      if (y == 1)              iBits &= ~CELL_NORTH;
+      if (y == ptMaze->iMazeH) iBits &= ~CELL_SOUTH;
+      if (x == 1)              iBits &= ~CELL_WEST;
+      if (x == ptMaze->iMazeW) iBits &= ~CELL_EAST;
+      ptMaze->pui8Around[llCell >> 1] |= iBits << ((llCell & 1) << 2);
+    }
+  }
+
+  ptMaze->bAround = 1;
+  markBroken(ptMaze, ptMaze->llExit);
+}
+
+/*******************************************************************************
+ * Name:  freeAround
+ * Purpose: Frees the masks once the generator is done.
+ *******************************************************************************/
+void freeAround(t_maze* ptMaze) {
+  free(ptMaze->pui8Around);
+  ptMaze->pui8Around = NULL;
+  ptMaze->bAround    = 0;
+}
+
+/*******************************************************************************
+ * Name:  probeAround
+ * Purpose: Returns the whole neighbours of a cell as CELL_* bits, without
+ *          masks.
  *******************************************************************************/
-void goToCell(int iDir, int* piCell) {
-  if (iDir == DIR_NORTH) *piCell -= g_tMaze.iGridW;
-  if (iDir == DIR_WEST)  *piCell -= 1;
-  if (iDir == DIR_SOUTH) *piCell += g_tMaze.iGridW;
-  if (iDir == DIR_EAST)  *piCell += 1;
+int probeAround(t_maze* ptMaze, ll llCell) {
+  int iAround = 0;
+
+  for (int iDir = 0; iDir < DIR_MOD; ++iDir)
+    if (isDirCellWhole(ptMaze, iDir, llCell)) iAround |= getDirWall(iDir);
+  return iAround;
 }
 
 /*******************************************************************************
  * Name:  breakIntoCell
  * Purpose: Break into cell in direction.
  *******************************************************************************/
-void breakIntoCell(int iDir, int* piCell) {
-  // Break first wall of cell we come from.
-  g_tMaze.piCells[*piCell] /= getDirWall(iDir);
+void breakIntoCell(t_maze* ptMaze, int iDir, ll* pllCell) {
+  breakWall(ptMaze, iDir, *pllCell);
+  goToCell(ptMaze, iDir, pllCell);
+  markBroken(ptMaze, *pllCell);
+}
+
+/*******************************************************************************
+ * Name:  initGrid
+ * Purpose: Sets all cells whole and marks the border.
+ *******************************************************************************/
+void initGrid(t_maze* ptMaze) {
+  int iW = ptMaze->iGridW;
+  int iH = ptMaze->iGridH;
 
-  goToCell(iDir, piCell);
+  if (! ptMaze->bLarge) {
+    memset(ptMaze->pui8Cells, CELL_BORDER, ptMaze->llGridCount);
+    for (int y = 1; y < ptMaze->iMazeH + 1; ++y)
+      memset(&ptMaze->pui8Cells[xy2cell(ptMaze, 1, y)], CELL_WHOLE, ptMaze->iMazeW);
+    return;
+  }
 
-  // Break second wall of cell we gone to.
-  g_tMaze.piCells[*piCell] /= getDirWall(turnBack(iDir));
+  // All walls set, then clear the walls between border cells.
+  memset(ptMaze->pui64Packed, 0xff, ((ptMaze->llGridCount >> PACK_SHIFT) + 1) * sizeof(uint64_t));
+  for (int x = 0; x < iW; ++x) {
+    clearPacked(ptMaze, xy2cell(ptMaze, x, 0),      PACK_EAST);
+    clearPacked(ptMaze, xy2cell(ptMaze, x, iH - 1), PACK_BOTH);
+  }
+  for (int y = 1; y < iH - 1; ++y) {
+    clearPacked(ptMaze, xy2cell(ptMaze, 0,      y), PACK_SOUTH);
+    clearPacked(ptMaze, xy2cell(ptMaze, iW - 1, y), PACK_BOTH);
+  }
 }
 
 /*******************************************************************************
  * Name:  isACellAroundWhole
- * Purpose: Looks if a neighbour cell is whole.
+ * Purpose: Looks if a neighbour cell is whole, in the masks if there are any.
  *******************************************************************************/
-int isACellAroundWhole(int* piDir, int iCell) {
-  int   iDir    = *piDir;
-  int   iWhole  = 0;
-  int   iLeft   = randI(2);
-  float fDirTry = randF();
+int isACellAroundWhole(t_maze* ptMaze, int* piDir, ll llCell) {
+  int iDir    = *piDir;
+  int iWhole  = 0;
+  int iAround = 0;
+  int iBits   = 0;
+  int iLeft   = 0;
+
+  // Dead ends need no random draw, with masks not even a look at the
+  // neighbours. Without masks the draws stay the same, and so does the maze.
+  iAround = ptMaze->bAround ? getAround(ptMaze, llCell) : probeAround(ptMaze, llCell);
+  if (iAround == 0) return 0;
+
+  iBits = randBits(&ptMaze->tRand, 3);
+  iLeft = iBits & 0x04;
 
   // Find out if straight, left or right will be the first guess.
-  // 50% ahead  0    - 0.5
-  // 25% left   0.5  - 0.75
-  // 25% right  0.75 - 0.99
-  if (fDirTry > 0.5 && fDirTry <= 0.75) iDir = turnLeft(iDir);
-  if (fDirTry > 0.75)                   iDir = turnRight(iDir);
+  // 50% ahead  0, 1
+  // 25% left   2
+  // 25% right  3
+  if ((iBits & 0x03) == 2) iDir = turnLeft(iDir);
+  if ((iBits & 0x03) == 3) iDir = turnRight(iDir);
 
   // Find a whole cell around this cell in all directions.
   for (int i = 0; i < DIR_MOD; ++i) {
-    if (isDirCellWhole(iDir, iCell)) {
+    if (iAround & getDirWall(iDir)) {
       iWhole = 1;
       *piDir = iDir;
       break;
@@ -490,22 +1361,27 @@ int isACellAroundWhole(int* piDir, int iCell) {
  * Name:  goneToNextWholeCell
  * Purpose: Search for the next whole cell to break into or signals finish.
  *******************************************************************************/
-int goneToNextWholeCell(int* piDir, int* piCell) {
+int goneToNextWholeCell(t_maze* ptMaze, int* piDir, ll* pllCell) {
+  int iBack = 0;
+
   // Go back one cell, until a whole cell is found else end process.
-  while (! isACellAroundWhole(piDir, *piCell)) {
-    if ((*piCell = pullCell()) == -1)
+  while (! isACellAroundWhole(ptMaze, piDir, *pllCell)) {
+    if ((iBack = pullDir(ptMaze)) == -1)
       return 0;
+    goToCell(ptMaze, turnBack(iBack), pllCell);
   }
   // Break into cell if one was found.
-  breakIntoCell(*piDir, piCell);
+  breakIntoCell(ptMaze, *piDir, pllCell);
+  pushDir(ptMaze, *piDir);
   return 1;
 }
 
 /*******************************************************************************
  * Name:  waitForNextKey
- * Purpose: Waits until a key is pressed. Returns direction and wether to move.
+ * Purpose: Waits until a key is pressed. Returns direction and wether to move,
+ *          'h' toggles *pbHint.
  *******************************************************************************/
-int waitForNextKey(int* piDir) {
+int waitForNextKey(int* piDir, int* pbHint) {
   int c = 0;
   int m = 0;
 
@@ -525,6 +1401,8 @@ int waitForNextKey(int* piDir) {
     if (c == 'a') { m = MOVE_LEFT;  break; }
     if (c == 's') { m = MOVE_BACK;  break; }
     if (c == 'd') { m = MOVE_RIGHT; break; }
+
+    if (c == 'h') { *pbHint = ! *pbHint; return 0; }
   }
 
   if (m == MOVE_FRONT) { /* *piDir = *piDir */       return 1; }
@@ -538,10 +1416,10 @@ int waitForNextKey(int* piDir) {
  * Name:  moveInGrid
  * Purpose: Moves worker to next cell, if a wall is detected.
  *******************************************************************************/
-int moveInGrid(int iDir, int* piCell) {
-  if (! isWallInDir(iDir, *piCell)) {
-    if (! isBorder(iDir, *piCell)) {
-      goToCell(iDir, piCell);
+int moveInGrid(t_maze* ptMaze, int iDir, ll* pllCell) {
+  if (! isWallInDir(ptMaze, iDir, *pllCell)) {
+    if (! isBorder(ptMaze, iDir, *pllCell)) {
+      goToCell(ptMaze, iDir, pllCell);
       return 1;
     }
     else {
@@ -554,186 +1432,4006 @@ int moveInGrid(int iDir, int* piCell) {
 }
 
 /*******************************************************************************
- * Name:  clearScreen
- * Purpose: Clears screen prior printing.
+ * Name:  frameReserve
+ * Purpose: Makes room for sBytes more bytes in the frame.
  *******************************************************************************/
-void clearScreen(void) {
-  system("clear");
+void frameReserve(t_frame* ptFrame, size_t sBytes) {
+  size_t sSize = (ptFrame->sSize != 0) ? ptFrame->sSize : FRAME_SLACK;
+  char*  pcBuf = NULL;
+
+  if (ptFrame->sLen + sBytes <= ptFrame->sSize) return;
+
+  // Grow by doubling, so a frame of the same size never allocates again.
+  while (sSize < ptFrame->sLen + sBytes) sSize <<= 1;
+  if ((pcBuf = (char*) realloc(ptFrame->pcBuf, sSize)) == NULL)
+    dispatchError(ERR_ELSE, "Not enough memory for frame");
+  ptFrame->pcBuf = pcBuf;
+  ptFrame->sSize = sSize;
 }
 
 /*******************************************************************************
- * Name:  printWallIf
- * Purpose: Prints a wall if cell contains one in wanted direction.
+ * Name:  frameAdd
+ * Purpose: Appends sLen bytes to the frame.
  *******************************************************************************/
-void printWallIf(int iX, int iY, int iWall, const char* cWall, const char* cNoWall) {
-  if (g_tMaze.piCells[xy2cell(iX, iY)] % iWall == 0)
-    printf("%s", cWall);
-  else
-    printf("%s", cNoWall);
+void frameAdd(t_frame* ptFrame, const char* pc, size_t sLen) {
+  frameReserve(ptFrame, sLen);
+  memcpy(ptFrame->pcBuf + ptFrame->sLen, pc, sLen);
+  ptFrame->sLen += sLen;
 }
 
 /*******************************************************************************
- * Name:  printMaze
- * Purpose: Prints the 2D maze.
- *******************************************************************************/
-void printMaze(int iDir, int iCell) {
-  char* cCorner        = "+";
-  char* cWallNS        = "---+";
-  char* cNoWallNS      = "   +";
-  char* cWallE         = "   |";
-  char* cNoWallE       = "    ";
-  char  cWallEPos[5]   = " x |";
-  char  cNoWallEPos[5] = " x  ";
-  char* cWallW         = "|";
-  char* cNoWallW       = " ";
-  char* cWall          = NULL;
-  char* cNoWall        = NULL;
-  int   iMazeW         = 0;
-  int   iMazeH         = 0;
-
-  // Alter position-marker 'X' to actual direction-marker.
-  snprintf(cWallEPos,   5, " %c |", g_dChar[iDir]);
-  snprintf(cNoWallEPos, 5, " %c  ", g_dChar[iDir]);
-
-  // Get maze coordinates.
-  cell2xy(iCell, &iMazeW, &iMazeH);
-
-  // +---+---+---+     N   N   N
-  // |   |   |   |   W   E   E   E
-  // +---+---+---+     S   S   S
-  // |   |   |   |   W   E   E   E
-  // +---+---+---+     S   S   S
-  // |   |   |   |   W   E   E   E
-  // +---+---+---+     S   S   S
-
-  // First upper cell line
-  printf("%s", cCorner);
-  for (int x = 1; x < g_tMaze.iMazeW + 1; ++x)
-    printWallIf(x, 1, CELL_NORTH, cWallNS, cNoWallNS);
-  printf("\n");
+ * Name:  frameAddf
+ * Purpose: Appends formatted text to the frame.
+ *******************************************************************************/
+void frameAddf(t_frame* ptFrame, const char* pcFmt, ...) {
+  va_list vaArgs;
+  int     iLen = 0;
 
-  for (int y = 1; y < g_tMaze.iMazeH + 1; ++y) {
-    printWallIf(1, y, CELL_WEST, cWallW, cNoWallW);
-    for (int x = 1; x < g_tMaze.iMazeW + 1; ++x) {
-      if (y == iMazeH && x == iMazeW) {
-        cWall   = cWallEPos;
-        cNoWall = cNoWallEPos;
-      }
-      else {
-        cWall   = cWallE;
-        cNoWall = cNoWallE;
-      }
-      printWallIf(x, y, CELL_EAST, cWall, cNoWall);
-    }
-    printf("\n");
+  frameReserve(ptFrame, FRAME_SLACK);
+  va_start(vaArgs, pcFmt);
+  iLen = vsnprintf(ptFrame->pcBuf + ptFrame->sLen, ptFrame->sSize - ptFrame->sLen, pcFmt, vaArgs);
+  va_end(vaArgs);
 
-    printf("%s", cCorner);
-    for (int x = 1; x < g_tMaze.iMazeW + 1; ++x)
-      printWallIf(x, y, CELL_SOUTH, cWallNS, cNoWallNS);
-    printf("\n");
+  // Too long for the slack, format again into enough room.
+  if ((size_t) iLen >= ptFrame->sSize - ptFrame->sLen) {
+    frameReserve(ptFrame, (size_t) iLen + 1);
+    va_start(vaArgs, pcFmt);
+    vsnprintf(ptFrame->pcBuf + ptFrame->sLen, ptFrame->sSize - ptFrame->sLen, pcFmt, vaArgs);
+    va_end(vaArgs);
   }
-
-  printf("Cell = % 4d, Dir = %d (%c)\n", iCell, iDir, g_dChar[iDir]);
+  ptFrame->sLen += iLen;
 }
 
 /*******************************************************************************
- * Name:  print3DView
- * Purpose: Prints the maze in 1st person perspective.
+ * Name:  frameStart
+ * Purpose: Empties the frame and starts it in the screen's upper left corner.
  *******************************************************************************/
-void print3DView(int iDir, int iCell) {
-  /*\
-  //  \
-  //    \
-  //      \            __________
-  //       |         /|
-  //       |_______/  |
-  //       |_______|  |
-  //       |       \  |
-  //       |         \|__________
-  //      /
-  //    /
-  //  /
-   */
+void frameStart(t_frame* ptFrame) {
+  ptFrame->sLen = 0;
+  frameAdd(ptFrame, FRAME_HOME, sizeof(FRAME_HOME) - 1);
+}
 
-  int iDepthMax = 5;
+/*******************************************************************************
+ * Name:  frameFlush
+ * Purpose: Clears what is left of the last screen and writes the frame at once.
+ *******************************************************************************/
+void frameFlush(t_frame* ptFrame) {
+  size_t  sDone = 0;
+  ssize_t ssRv  = 0;
 
-  // Create window buffer to write to.
+  frameAdd(ptFrame, FRAME_EOS, sizeof(FRAME_EOS) - 1);
 
-  // Write ASCII into window buffer from far to near.
-  for (int depth = iDepthMax; depth >= 0; --depth) {
-    // Go to upper left corner to
-    for (int x = 0; x < g_tMaze.iMazeW; ++x) {
-      ;
+  // Anything printed before belongs above the frame.
+  fflush(stdout);
+  while (sDone < ptFrame->sLen) {
+    ssRv = write(STDOUT_FILENO, ptFrame->pcBuf + sDone, ptFrame->sLen - sDone);
+    if (ssRv <= 0) {
+      if (ssRv == -1 && errno == EINTR) continue;
+      break;
     }
+    sDone += (size_t) ssRv;
   }
+}
+
+/*******************************************************************************
+ * Name:  getScreenSize
+ * Purpose: Gets the terminal's columns and rows, if stdout is none it's as big
+ *          as a grid of GRID_MAX cells.
+ *******************************************************************************/
+void getScreenSize(int* piCols, int* piRows) {
+  struct winsize tWin = {0};
 
-  // Print window buffer to stdout.
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &tWin) == 0 && tWin.ws_col != 0 && tWin.ws_row != 0) {
+    *piCols = tWin.ws_col;
+    *piRows = tWin.ws_row;
+  }
+  else {
+    *piCols = FRAME_COLS;
+    *piRows = FRAME_ROWS;
+  }
 }
 
 /*******************************************************************************
- * Name:  generateMaze
- * Purpose: Generates a complete maze within the border of the grid.
+ * Name:  frameView
+ * Purpose: Fits the view into a screen of iCols x iRows and scrolls it once
+ *          llCell comes near its edge. Returns 1 if the view has changed.
  *******************************************************************************/
-int generateMaze(int* piCell) {
-  int iCell     = 0;
-  int iCellLast = 0;
-  int iDir      = 0;
-  int iX        = 0;
-  int iY        = 0;
+int frameView(t_frame* ptFrame, t_maze* ptMaze, ll llCell, int iCols, int iRows) {
+  int i3DRows = 0;
+  int iViewW  = 0;
+  int iViewH  = 0;
+  int iViewX  = ptFrame->iViewX;
+  int iViewY  = ptFrame->iViewY;
+  int iMazeX  = 0;
+  int iMazeY  = 0;
 
-  // Init the grid's cells and the border.
-  for (int i = 0; i < g_tMaze.iGridCount; ++i)
-    g_tMaze.piCells[i] = CELL_BORDER;
+  // The first person view goes right of the grid, cut at the status lines.
+  if (ptFrame->b3D && iCols >= 5 + VIEW_GAP + VIEW_W && iRows > FRAME_LINES) {
+    i3DRows  = (iRows - FRAME_LINES < VIEW_H) ? iRows - FRAME_LINES : VIEW_H;
+    iCols   -= VIEW_GAP + VIEW_W;
+  }
+  iViewW = (iCols - 1) / 4;
+  iViewH = (iRows - 1 - FRAME_LINES) / 2;
 
-  for (int y = 1; y < g_tMaze.iMazeH + 1; ++y)
-    for (int x = 1; x < g_tMaze.iMazeW + 1; ++x)
-      g_tMaze.piCells[xy2cell(x, y)] = CELL_WHOLE;
+  // Cells are 4 columns and 2 rows, plus the west and north walls.
+  iViewW = (iViewW < 1) ? 1 : (iViewW > ptMaze->iMazeW) ? ptMaze->iMazeW : iViewW;
+  iViewH = (iViewH < 1) ? 1 : (iViewH > ptMaze->iMazeH) ? ptMaze->iMazeH : iViewH;
 
-  // Get an entry cell a the edge.
-  //   X 1   2   3
-  // Y +---+---+---+
-  // 1 |   |   |   |       N
-  //   +---+---+---+       |
+  cell2xy(ptMaze, llCell, &iMazeX, &iMazeY);
+
+  // Center the cell again if it is within a quarter of the view to its edge
+  // or the screen was resized, but never show anything beside the maze.
+  if (iViewW != ptFrame->iViewW || iMazeX < iViewX + iViewW / 4 || iMazeX >= iViewX + iViewW - iViewW / 4)
+    iViewX = iMazeX - iViewW / 2;
+  if (iViewH != ptFrame->iViewH || iMazeY < iViewY + iViewH / 4 || iMazeY >= iViewY + iViewH - iViewH / 4)
+    iViewY = iMazeY - iViewH / 2;
+  iViewX = (iViewX > ptMaze->iMazeW - iViewW + 1) ? ptMaze->iMazeW - iViewW + 1 : iViewX;
+  iViewY = (iViewY > ptMaze->iMazeH - iViewH + 1) ? ptMaze->iMazeH - iViewH + 1 : iViewY;
+  iViewX = (iViewX < 1) ? 1 : iViewX;
+  iViewY = (iViewY < 1) ? 1 : iViewY;
+
+  if (iViewX == ptFrame->iViewX && iViewY == ptFrame->iViewY &&
+      iViewW == ptFrame->iViewW && iViewH == ptFrame->iViewH && i3DRows == ptFrame->i3DRows)
+    return 0;
+
+  ptFrame->iViewX  = iViewX;
+  ptFrame->iViewY  = iViewY;
+  ptFrame->iViewW  = iViewW;
+  ptFrame->iViewH  = iViewH;
+  ptFrame->i3DRows = i3DRows;
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  frameMarker
+ * Purpose: Composes a cursor addressed update of the marker in a cell.
+ *******************************************************************************/
+void frameMarker(t_frame* ptFrame, t_maze* ptMaze, ll llCell, char cMarker) {
+  int iMazeX = 0;
+  int iMazeY = 0;
+
+  // A cell's middle is in line 2 * y of the view, column 4 * x - 1.
+  cell2xy(ptMaze, llCell, &iMazeX, &iMazeY);
+  frameAddf(ptFrame, FRAME_GOTO "%c", 2 * (iMazeY - ptFrame->iViewY + 1),
+            4 * (iMazeX - ptFrame->iViewX + 1) - 1, cMarker);
+}
+
+/*******************************************************************************
+ * Name:  frameGrid
+ * Purpose: Composes the 2D maze's grid in the view with the position marker.
+ *******************************************************************************/
+void frameGrid(t_frame* ptFrame, t_maze* ptMaze, int iDir, ll llCell) {
+  size_t sLine  = 4 * (size_t) ptFrame->iViewW + 1 + sizeof(FRAME_EOL "\n") - 1;
+  char*  pc     = NULL;
+  ll     llRow  = 0;
+  int    iMazeX = 0;
+  int    iMazeY = 0;
+
+  // +---+---+---+     N   N   N
+  // |   |   |   |   W   E   E   E
+  // +---+---+---+     S   S   S
+  // |   |   |   |   W   E   E   E
+  // +---+---+---+     S   S   S
+  // |   |   |   |   W   E   E   E
+  // +---+---+---+     S   S   S
+
+  // Get maze coordinates.
+  cell2xy(ptMaze, llCell, &iMazeX, &iMazeY);
+
+  // All lines at once, the segments are copied like in exportMaze().
+  frameReserve(ptFrame, sLine * (2 * (size_t) ptFrame->iViewH + 1));
+  pc = ptFrame->pcBuf + ptFrame->sLen;
+
+  // First upper cell line
+  llRow = xy2cell(ptMaze, ptFrame->iViewX, ptFrame->iViewY);
+  *pc++ = '+';
+  for (int x = 0; x < ptFrame->iViewW; ++x, pc += 4)
+    memcpy(pc, isWallInDir(ptMaze, DIR_NORTH, llRow + x) ? "---+" : "   +", 4);
+  memcpy(pc, FRAME_EOL "\n", sizeof(FRAME_EOL "\n") - 1);
+  pc += sizeof(FRAME_EOL "\n") - 1;
+
+  for (int y = ptFrame->iViewY; y < ptFrame->iViewY + ptFrame->iViewH; ++y) {
+    llRow = xy2cell(ptMaze, ptFrame->iViewX, y);
+
+    *pc++ = isWallInDir(ptMaze, DIR_WEST, llRow) ? '|' : ' ';
+    for (int x = 0; x < ptFrame->iViewW; ++x, pc += 4)
+      memcpy(pc, isWallInDir(ptMaze, DIR_EAST, llRow + x) ? "   |" : "    ", 4);
+    // Direction marker in the middle of the position's cell.
+    if (y == iMazeY && iMazeX >= ptFrame->iViewX && iMazeX < ptFrame->iViewX + ptFrame->iViewW)
+      pc[-4 * (ptFrame->iViewX + ptFrame->iViewW - iMazeX) + 1] = g_dChar[iDir];
+    memcpy(pc, FRAME_EOL "\n", sizeof(FRAME_EOL "\n") - 1);
+    pc += sizeof(FRAME_EOL "\n") - 1;
+
+    *pc++ = '+';
+    for (int x = 0; x < ptFrame->iViewW; ++x, pc += 4)
+      memcpy(pc, isWallInDir(ptMaze, DIR_SOUTH, llRow + x) ? "---+" : "   +", 4);
+    memcpy(pc, FRAME_EOL "\n", sizeof(FRAME_EOL "\n") - 1);
+    pc += sizeof(FRAME_EOL "\n") - 1;
+  }
+
+  ptFrame->sLen = pc - ptFrame->pcBuf;
+
+  // The grid's lines cleared the first person view beside them.
+  ptFrame->bDrawn   = 1;
+  ptFrame->b3DDrawn = 0;
+  ptFrame->llCell   = llCell;
+  ptFrame->iDir     = iDir;
+}
+
+/*******************************************************************************
+ * Name:  frameMaze
+ * Purpose: Composes the 2D maze in a view of the terminal's size and the
+ *          position line.
+ *******************************************************************************/
+void frameMaze(t_frame* ptFrame, t_maze* ptMaze, int iDir, ll llCell) {
+  int iCols = 0;
+  int iRows = 0;
+  int iLine = 0;
+
+  // Asking each frame notices a resized terminal at the next key.
+  getScreenSize(&iCols, &iRows);
+  if (frameView(ptFrame, ptMaze, llCell, iCols, iRows)) ptFrame->bDrawn = 0;
+
+  if (! ptFrame->bDrawn) {
+    frameGrid(ptFrame, ptMaze, iDir, llCell);
+  }
+  // Only the marker moved or turned, the walls are on the screen.
+  else {
+    if (llCell != ptFrame->llCell)
+      frameMarker(ptFrame, ptMaze, ptFrame->llCell, ' ');
+    if (llCell != ptFrame->llCell || iDir != ptFrame->iDir)
+      frameMarker(ptFrame, ptMaze, llCell, g_dChar[iDir]);
+    ptFrame->llCell = llCell;
+    ptFrame->iDir   = iDir;
+  }
+
+  // Status lines below the grid and the first person view.
+  iLine = (2 * ptFrame->iViewH + 1 > ptFrame->i3DRows) ? 2 * ptFrame->iViewH + 1 : ptFrame->i3DRows;
+  frameAddf(ptFrame, FRAME_GOTO, iLine + 1, 1);
+
+  frameAddf(ptFrame, "Cell = % 4lld, Dir = %d (%c), Seed = %lld" FRAME_EOL "\n",
+            llCell, iDir, g_dChar[iDir], ptMaze->llSeed);
+}
+
+/*******************************************************************************
+ * Name:  printMaze
+ * Purpose: Prints the 2D maze and the position line as the whole screen. The
+ *          walls may have changed since the last call.
+ *******************************************************************************/
+void printMaze(t_maze* ptMaze, int iDir, ll llCell) {
+  ptMaze->tFrame.bDrawn = 0;
+  frameStart(&ptMaze->tFrame);
+  frameMaze(&ptMaze->tFrame, ptMaze, iDir, llCell);
+  frameFlush(&ptMaze->tFrame);
+}
+
+/*******************************************************************************
+ * Name:  exportMaze
+ * Purpose: Writes the maze without position marker line by line into a file.
+ *******************************************************************************/
+void exportMaze(t_maze* ptMaze, FILE* hFile) {
+  char* pcLine = (char*) malloc(4 * (size_t) ptMaze->iMazeW + 2);
+  char* pc     = NULL;
+  ll    llCell = 0;
+
+  if (pcLine == NULL) dispatchError(ERR_ELSE, "Not enough memory for export");
+
+  // Same layout as frameGrid(), but each text line is written at once.
+  pc    = pcLine;
+  *pc++ = '+';
+  llCell = xy2cell(ptMaze, 1, 1);
+  for (int x = 0; x < ptMaze->iMazeW; ++x, pc += 4)
+    memcpy(pc, isWallInDir(ptMaze, DIR_NORTH, llCell + x) ? "---+" : "   +", 4);
+  *pc++ = '\n';
+  fwrite(pcLine, 1, pc - pcLine, hFile);
+
+  for (int y = 1; y < ptMaze->iMazeH + 1; ++y) {
+    llCell = xy2cell(ptMaze, 1, y);
+
+    pc    = pcLine;
+    *pc++ = isWallInDir(ptMaze, DIR_WEST, llCell) ? '|' : ' ';
+    for (int x = 0; x < ptMaze->iMazeW; ++x, pc += 4)
+      memcpy(pc, isWallInDir(ptMaze, DIR_EAST, llCell + x) ? "   |" : "    ", 4);
+    *pc++ = '\n';
+    fwrite(pcLine, 1, pc - pcLine, hFile);
+
+    pc    = pcLine;
+    *pc++ = '+';
+    for (int x = 0; x < ptMaze->iMazeW; ++x, pc += 4)
+      memcpy(pc, isWallInDir(ptMaze, DIR_SOUTH, llCell + x) ? "---+" : "   +", 4);
+    *pc++ = '\n';
+    fwrite(pcLine, 1, pc - pcLine, hFile);
+  }
+
+  free(pcLine);
+}
+
+/*******************************************************************************
+ * Name:  viewMirror
+ * Purpose: Returns the character for the other side of the view.
+ *******************************************************************************/
+char viewMirror(char c) {
+  if (c == '\\') return '/';
+  if (c == '/')  return '\\';
+  return c;
+}
+
+/*******************************************************************************
+ * Name:  viewInit
+ * Purpose: Draws the templates of the first person view into g_tView.
+ *******************************************************************************/
+void viewInit(void) {
+  // Rows between each plane and the view's upper edge. Walls run down one row
+  // per two columns, so terminal cells look about square.
+  int     aiPlane[VIEW_DEPTH + 2] = {0, 3, 5, 6, 7, 8, 9};
+  t_view* ptView                  = &g_tView;
+  int     iX0                     = 0;
+  int     iX1                     = 0;
+  int     iY0                     = 0;
+  int     iY1                     = 0;
+
+  memset(ptView, ' ', sizeof(t_view));
+  for (int p = 0; p < VIEW_DEPTH + 2; ++p) {
+    ptView->aiY[p] = aiPlane[p];
+    ptView->aiX[p] = 2 * aiPlane[p];
+  }
+
+  for (int d = 0; d < VIEW_DEPTH + 1; ++d) {
+    iX0 = ptView->aiX[d];
+    iX1 = ptView->aiX[d + 1];
+    iY0 = ptView->aiY[d];
+    iY1 = ptView->aiY[d + 1];
+
+    //   \        Side wall from plane d to d + 1, its upper
+    //     \      and lower edge.
+    //     /
+    //   /
+    for (int k = 0; k < iY1 - iY0; ++k) {
+      ptView->acLeft[VIEW_WALL][d][iY0 + k][iX0 + 2 * k]              = '\\';
+      ptView->acLeft[VIEW_WALL][d][VIEW_H - 1 - iY0 - k][iX0 + 2 * k] = '/';
+    }
+
+    //   |____    Side opening, the end of the wall before it and the wall
+    //   |        across the side cell, which is as far as the next plane.
+    //   |____
+    //   |
+    if (d != 0)
+      for (int y = iY0; y < VIEW_H - iY0; ++y)
+        ptView->acLeft[VIEW_OPEN][d][y][iX0] = '|';
+    for (int x = (d != 0) ? iX0 + 1 : iX0; x < iX1; ++x) {
+      ptView->acLeft[VIEW_OPEN][d][iY1 - 1][x]          = '_';
+      ptView->acLeft[VIEW_OPEN][d][VIEW_H - 1 - iY1][x] = '_';
+    }
+
+    //  _____     Wall behind cell d, as far as the next plane.
+    // |     |
+    // |_____|
+    for (int x = iX1 + 1; x < VIEW_W - 1 - iX1; ++x) {
+      ptView->acFront[d][iY1 - 1][x]          = '_';
+      ptView->acFront[d][VIEW_H - 1 - iY1][x] = '_';
+    }
+    for (int y = iY1; y < VIEW_H - iY1; ++y) {
+      ptView->acFront[d][y][iX1]              = '|';
+      ptView->acFront[d][y][VIEW_W - 1 - iX1] = '|';
+    }
+  }
+
+  // The right side is the left one mirrored.
+  for (int i = 0; i < VIEW_PARTS; ++i)
+    for (int d = 0; d < VIEW_DEPTH + 1; ++d)
+      for (int y = 0; y < VIEW_H; ++y)
+        for (int x = 0; x < VIEW_W; ++x)
+          ptView->acRight[i][d][y][VIEW_W - 1 - x] = viewMirror(ptView->acLeft[i][d][y][x]);
+}
+
+/*******************************************************************************
+ * Name:  viewWalk
+ * Purpose: Walks from llCell up to VIEW_DEPTH cells in iDir. Returns the depth
+ *          of the last cell in sight, the side openings as a bit per depth and
+ *          whether a wall is behind the last cell.
+ *******************************************************************************/
+int viewWalk(t_maze* ptMaze, int iDir, ll llCell, int* piOpenL, int* piOpenR, int* pbFront) {
+  int iDepth = 0;
+
+  *piOpenL = 0;
+  *piOpenR = 0;
+  while (1) {
+    if (! isWallInDir(ptMaze, turnLeft(iDir), llCell))  *piOpenL |= 1 << iDepth;
+    if (! isWallInDir(ptMaze, turnRight(iDir), llCell)) *piOpenR |= 1 << iDepth;
+    *pbFront = isWallInDir(ptMaze, iDir, llCell);
+
+    // The exit leads into the border, nothing to see beyond.
+    if (*pbFront || iDepth == VIEW_DEPTH || isBorder(ptMaze, iDir, llCell)) break;
+    goToCell(ptMaze, iDir, &llCell);
+    ++iDepth;
+  }
+  return iDepth;
+}
+
+/*******************************************************************************
+ * Name:  sightFree
+ * Purpose: Frees the sight records.
+ *******************************************************************************/
+void sightFree(t_sight* ptSight) {
+  free(ptSight->pui16Rec);
+  ptSight->pui16Rec = NULL;
+}
+
+/*******************************************************************************
+ * Name:  sightRec
+ * Purpose: Returns the sight record of a cell with the walls iWalls. The next
+ *          cell in iDir has the record ui16Next, if there is a way into it.
+ *******************************************************************************/
+uint16_t sightRec(int iWalls, int iDir, int bBorder, uint16_t ui16Next) {
+  uint16_t ui16Rec = 0;
+  int      iDepth  = 0;
+
+  if (! (iWalls & getDirWall(turnLeft(iDir))))  ui16Rec |= 1;
+  if (! (iWalls & getDirWall(turnRight(iDir)))) ui16Rec |= 1 << SIGHT_RIGHT;
+
+  if (iWalls & getDirWall(iDir)) return ui16Rec | SIGHT_FRONT;
+  if (bBorder) return ui16Rec;
+
+  // The next cell's sight one step further. If it saw as far as possible, its
+  // last but one cell is the last one here, which has a way on.
+  iDepth   = (ui16Next >> SIGHT_DEPTH) & 0x07;
+  ui16Rec |= ((ui16Next & SIGHT_OPENS) << 1) & SIGHT_OPENS;
+  ui16Rec |= ((((ui16Next >> SIGHT_RIGHT) & SIGHT_OPENS) << 1) & SIGHT_OPENS) << SIGHT_RIGHT;
+  if (iDepth == VIEW_DEPTH) return ui16Rec | (VIEW_DEPTH << SIGHT_DEPTH);
+  return ui16Rec | ((iDepth + 1) << SIGHT_DEPTH) | (ui16Next & SIGHT_FRONT);
+}
+
+/*******************************************************************************
+ * Name:  sightInit
+ * Purpose: Builds the sight records of all cells in one sweep forward for
+ *          north and west, whose next cells come first, and one backward for
+ *          south and east. Returns 0 if there is not enough memory or the
+ *          grid has more than SIGHT_MAX cells, larger mazes walk the cells.
+ *******************************************************************************/
+int sightInit(t_sight* ptSight, t_maze* ptMaze) {
+  uint16_t* pui16 = NULL;
+  ll        llRow = 0;
+  ll        llC   = 0;
+  int       iW    = 0;
+
+  sightFree(ptSight);
+  if (ptMaze->llGridCount > SIGHT_MAX) return 0;
+  // Border records stay 0, the edge cells read them without using them.
+  if ((ptSight->pui16Rec = (uint16_t*) calloc(ptMaze->llGridCount * DIR_MOD, sizeof(uint16_t))) == NULL)
+    return 0;
+  pui16 = ptSight->pui16Rec;
+
+  for (int y = 1; y < ptMaze->iMazeH + 1; ++y) {
+    llRow = xy2cell(ptMaze, 0, y);
+    for (int x = 1; x < ptMaze->iMazeW + 1; ++x) {
+      llC = llRow + x;
+      iW  = getCellWalls(ptMaze, llC);
+      pui16[llC * DIR_MOD + DIR_NORTH] = sightRec(iW, DIR_NORTH, y == 1,
+                                                  pui16[(llC - ptMaze->iGridW) * DIR_MOD + DIR_NORTH]);
+      pui16[llC * DIR_MOD + DIR_WEST]  = sightRec(iW, DIR_WEST, x == 1, pui16[(llC - 1) * DIR_MOD + DIR_WEST]);
+    }
+  }
+
+  for (int y = ptMaze->iMazeH; y > 0; --y) {
+    llRow = xy2cell(ptMaze, 0, y);
+    for (int x = ptMaze->iMazeW; x > 0; --x) {
+      llC = llRow + x;
+      iW  = getCellWalls(ptMaze, llC);
+      pui16[llC * DIR_MOD + DIR_SOUTH] = sightRec(iW, DIR_SOUTH, y == ptMaze->iMazeH,
+                                                  pui16[(llC + ptMaze->iGridW) * DIR_MOD + DIR_SOUTH]);
+      pui16[llC * DIR_MOD + DIR_EAST]  = sightRec(iW, DIR_EAST, x == ptMaze->iMazeW,
+                                                  pui16[(llC + 1) * DIR_MOD + DIR_EAST]);
+    }
+  }
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  sightWalk
+ * Purpose: Returns the sight like viewWalk(), from the records if there are
+ *          any.
+ *******************************************************************************/
+int sightWalk(t_sight* ptSight, t_maze* ptMaze, int iDir, ll llCell, int* piOpenL, int* piOpenR,
+              int* pbFront) {
+  uint16_t ui16Rec = 0;
+
+  if (ptSight->pui16Rec == NULL)
+    return viewWalk(ptMaze, iDir, llCell, piOpenL, piOpenR, pbFront);
+
+  ui16Rec  = ptSight->pui16Rec[llCell * DIR_MOD + iDir];
+  *piOpenL = ui16Rec & SIGHT_OPENS;
+  *piOpenR = (ui16Rec >> SIGHT_RIGHT) & SIGHT_OPENS;
+  *pbFront = (ui16Rec & SIGHT_FRONT) != 0;
+  return (ui16Rec >> SIGHT_DEPTH) & 0x07;
+}
+
+/*******************************************************************************
+ * Name:  print3DView
+ * Purpose: Composes the maze in 1st person perspective beside the grid. Only
+ *          the view's rows that differ from the screen are sent.
+ *******************************************************************************/
+void print3DView(t_frame* ptFrame, t_sight* ptSight, t_maze* ptMaze, int iDir, ll llCell) {
+  t_view* ptView = &g_tView;
+  char    ac3D[VIEW_H][VIEW_W];
+  int     iOpenL = 0;
+  int     iOpenR = 0;
+  int     bFront = 0;
+  int     iDepth = 0;
+  int     iFar   = 0;
+  int     iX     = 0;
+  int     iLen   = 0;
+  int     iCol   = 4 * ptFrame->iViewW + 1 + VIEW_GAP + 1;
+
+  if (ptFrame->i3DRows == 0) return;
+
+  iDepth = sightWalk(ptSight, ptMaze, iDir, llCell, &iOpenL, &iOpenR, &bFront);
+  iFar   = ptView->aiX[iDepth + 1];
+
+  // Write the templates into the view buffer, no two parts share a column.
+  for (int y = 0; y < VIEW_H; ++y) {
+    for (int d = 0; d < iDepth + 1; ++d) {
+      iX   = ptView->aiX[d];
+      iLen = ptView->aiX[d + 1] - iX;
+      memcpy(&ac3D[y][iX], &ptView->acLeft[(iOpenL >> d) & 1][d][y][iX], iLen);
+      memcpy(&ac3D[y][VIEW_W - iX - iLen], &ptView->acRight[(iOpenR >> d) & 1][d][y][VIEW_W - iX - iLen], iLen);
+    }
+    memcpy(&ac3D[y][iFar], (bFront ? ptView->acFront[iDepth][y] : ptView->acFar[y]) + iFar, VIEW_W - 2 * iFar);
+  }
+
+  // Changed rows go to the screen, the cursor comes back for the status lines.
+  frameAdd(ptFrame, FRAME_SAVE, sizeof(FRAME_SAVE) - 1);
+  for (int y = 0; y < ptFrame->i3DRows; ++y) {
+    if (ptFrame->b3DDrawn && memcmp(ac3D[y], ptFrame->ac3D[y], VIEW_W) == 0) continue;
+    // Lines below the grid still hold the last screen.
+    if (! ptFrame->b3DDrawn && y >= 2 * ptFrame->iViewH + 1)
+      frameAddf(ptFrame, FRAME_GOTO FRAME_EOL, y + 1, 1);
+    frameAddf(ptFrame, FRAME_GOTO, y + 1, iCol);
+    frameAdd(ptFrame, ac3D[y], VIEW_W);
+  }
+  frameAdd(ptFrame, FRAME_BACK, sizeof(FRAME_BACK) - 1);
+
+  memcpy(ptFrame->ac3D, ac3D, sizeof(ac3D));
+  ptFrame->b3DDrawn = 1;
+}
+
+/*******************************************************************************
+ * Name:  generateBacktrack
+ * Purpose: Recursive backtracker starting at the exit cell. Returns the last
+ *          cell and direction as starting point, or -1 if out of memory.
+ *******************************************************************************/
+int generateBacktrack(t_maze* ptMaze, ll llCell, int iDir, ll* pllCell, int bAnimate) {
+  ll llCellLast = 0;
+
+  // The path may reach every cell, 2 bits per step.
+  if ((ptMaze->tStack.pui8Dir = (uint8_t*) malloc((ptMaze->llMazeCount >> 2) + 1)) == NULL)
+    return -1;
+
+  // Keep track of the whole neighbours.
+  initAround(ptMaze);
+
+  // The first cell is where walking back ends.
+  ptMaze->tStack.llSize    = STACK_EMPTY;
+  ptMaze->tStack.llMaxSize = STACK_EMPTY;
+
+  // Walk through the maze and break walls until no cell is left to break into.
+  while (1) {
+    if (bAnimate) {
+      printMaze(ptMaze, iDir, llCell);
+      usleep(80000);
+    }
+    llCellLast = llCell;
+    if (! goneToNextWholeCell(ptMaze, &iDir, &llCell)) break;
+  }
+
+  // Last cell will be the starting point.
+  *pllCell = llCellLast;
+  freeAround(ptMaze);
+  free(ptMaze->tStack.pui8Dir);
+  ptMaze->tStack.pui8Dir = NULL;
+
+  return iDir;
+}
+
+/*******************************************************************************
+ * Name:  runThreads
+ * Purpose: Runs a function on the maze's threads and waits for all of them.
+ *          Workers take jobs until none is left, so fewer threads than wanted
+ *          only take longer. If none starts, the caller does the work.
+ *******************************************************************************/
+void runThreads(t_maze* ptMaze, void* (*pfWorker)(void*), void* pvArg) {
+  pthread_t* ptThreads = (pthread_t*) malloc(ptMaze->iThreads * sizeof(pthread_t));
+  int        iStarted  = 0;
+
+  if (ptThreads != NULL)
+    while (iStarted < ptMaze->iThreads &&
+           pthread_create(&ptThreads[iStarted], NULL, pfWorker, pvArg) == 0)
+      ++iStarted;
+
+  if (iStarted == 0) pfWorker(pvArg);
+  for (int i = 0; i < iStarted; ++i)
+    pthread_join(ptThreads[i], NULL);
+
+  free(ptThreads);
+}
+
+/*******************************************************************************
+ * Name:  isACellAroundWholeInTile
+ * Purpose: Same as isACellAroundWhole(), but only looks inside of a tile.
+ *******************************************************************************/
+int isACellAroundWholeInTile(t_maze* ptMaze, t_tile* ptTile, t_rand* ptRand, int* piDir, int iX, int iY) {
+  int iDir  = *piDir;
+  int iBits = randBits(ptRand, 3);
+  int iNX   = 0;
+  int iNY   = 0;
+
+  // 50% ahead, 25% left, 25% right as first guess.
+  if ((iBits & 0x03) == 2) iDir = turnLeft(iDir);
+  if ((iBits & 0x03) == 3) iDir = turnRight(iDir);
+
+  for (int i = 0; i < DIR_MOD; ++i) {
+    iNX = iX + (iDir == DIR_EAST)  - (iDir == DIR_WEST);
+    iNY = iY + (iDir == DIR_SOUTH) - (iDir == DIR_NORTH);
+    if (iNX >= 0 && iNX < ptTile->iW && iNY >= 0 && iNY < ptTile->iH &&
+        isCellWhole(ptMaze, xy2cell(ptMaze, ptTile->iX + iNX, ptTile->iY + iNY))) {
+      *piDir = iDir;
+      return 1;
+    }
+    iDir = (iBits & 0x04) ? turnLeft(iDir) : turnRight(iDir);
+  }
+
+  return 0;
+}
+
+/*******************************************************************************
+ * Name:  carveTile
+ * Purpose: Backtracker confined to one tile. The stack holds tile coordinates
+ *          as (y << 16 | x), so it needs no division to get them back.
+ *******************************************************************************/
+void carveTile(t_maze* ptMaze, t_tile* ptTile, t_rand* ptRand, uint32_t* pui32Stack) {
+  size_t sStack = STACK_EMPTY;
+  int    iX     = (int) randI(ptRand, ptTile->iW);
+  int    iY     = (int) randI(ptRand, ptTile->iH);
+  int    iDir   = randBits(ptRand, 2);
+
+  pui32Stack[sStack++] = (uint32_t) iY << 16 | iX;
+
+  while (1) {
+    if (isACellAroundWholeInTile(ptMaze, ptTile, ptRand, &iDir, iX, iY)) {
+      breakWall(ptMaze, iDir, xy2cell(ptMaze, ptTile->iX + iX, ptTile->iY + iY));
+      iX += (iDir == DIR_EAST)  - (iDir == DIR_WEST);
+      iY += (iDir == DIR_SOUTH) - (iDir == DIR_NORTH);
+      pui32Stack[sStack++] = (uint32_t) iY << 16 | iX;
+      continue;
+    }
+    if (--sStack == STACK_EMPTY) break;
+    iX = pui32Stack[sStack - 1] & 0xffff;
+    iY = pui32Stack[sStack - 1] >> 16;
+  }
+}
+
+/*******************************************************************************
+ * Name:  getTile
+ * Purpose: Returns the cell rectangle of tile number iTile.
+ *******************************************************************************/
+t_tile getTile(t_maze* ptMaze, int iTilesW, int iTile) {
+  t_tile tTile = {0};
+
+  tTile.iX = (iTile % iTilesW) * TILE_SIZE + 1;
+  tTile.iY = (iTile / iTilesW) * TILE_SIZE + 1;
+  tTile.iW = ptMaze->iMazeW + 1 - tTile.iX;
+  tTile.iH = ptMaze->iMazeH + 1 - tTile.iY;
+  if (tTile.iW > TILE_SIZE) tTile.iW = TILE_SIZE;
+  if (tTile.iH > TILE_SIZE) tTile.iH = TILE_SIZE;
+
+  return tTile;
+}
+
+/*******************************************************************************
+ * Name:  tileWorker
+ * Purpose: Thread carving tiles until none is left.
+ *******************************************************************************/
+void* tileWorker(void* pvTiles) {
+  t_tiles*  ptTiles    = (t_tiles*) pvTiles;
+  t_maze*   ptMaze     = ptTiles->ptMaze;
+  uint32_t* pui32Stack = (uint32_t*) malloc(TILE_SIZE * TILE_SIZE * sizeof(uint32_t));
+  t_rand    tRand      = {0};
+  t_tile    tTile      = {0};
+  int       iTile      = 0;
+
+  if (pui32Stack == NULL) {
+    __atomic_store_n(&ptTiles->bFailed, 1, __ATOMIC_RELAXED);
+    return NULL;
+  }
+
+  while ((iTile = __atomic_fetch_add(&ptTiles->iNext, 1, __ATOMIC_RELAXED)) < ptTiles->iTilesW * ptTiles->iTilesH) {
+    // Seed per tile, the maze doesn't depend on the number of threads.
+    randSeed(&tRand, (uint64_t) ptMaze->llSeed + 0x9e3779b97f4a7c15ULL * (iTile + 1));
+    tTile = getTile(ptMaze, ptTiles->iTilesW, iTile);
+    carveTile(ptMaze, &tTile, &tRand, pui32Stack);
+  }
+
+  free(pui32Stack);
+  return NULL;
+}
+
+/*******************************************************************************
+ * Name:  joinTiles
+ * Purpose: Random spanning tree over the tiles, opens one wall per tree edge.
+ *          Returns 0 if there is not enough memory.
+ *******************************************************************************/
+int joinTiles(t_maze* ptMaze, int iTilesW, int iTilesH) {
+  int      iCount  = iTilesW * iTilesH;
+  int*     piStack = (int*) malloc(iCount * sizeof(int));
+  uint8_t* pui8Vis = (uint8_t*) calloc(iCount, sizeof(uint8_t));
+  int      iStack  = 0;
+  int      iTile   = 0;
+  int      iNext   = 0;
+  int      iDir    = 0;
+  int      iFound  = 0;
+  t_tile   tTile   = {0};
+  ll       llCell  = 0;
+
+  if (piStack == NULL || pui8Vis == NULL) {
+    free(piStack);
+    free(pui8Vis);
+    return 0;
+  }
+
+  // Backtracker on the tile grid.
+  iTile              = (int) randI(&ptMaze->tRand, iCount);
+  pui8Vis[iTile]     = 1;
+  piStack[iStack++]  = iTile;
+
+  while (iStack != 0) {
+    iTile  = piStack[iStack - 1];
+    iDir   = randBits(&ptMaze->tRand, 2);
+    iFound = 0;
+
+    for (int i = 0; i < DIR_MOD && ! iFound; ++i, iDir = turnLeft(iDir)) {
+      if (iDir == DIR_NORTH && iTile <  iTilesW)                continue;
+      if (iDir == DIR_SOUTH && iTile >= iCount - iTilesW)       continue;
+      if (iDir == DIR_WEST  && iTile % iTilesW == 0)            continue;
+      if (iDir == DIR_EAST  && iTile % iTilesW == iTilesW - 1)  continue;
+
+      iNext = iTile + (iDir == DIR_EAST) - (iDir == DIR_WEST) +
+              ((iDir == DIR_SOUTH) - (iDir == DIR_NORTH)) * iTilesW;
+      if (pui8Vis[iNext]) continue;
+
+      // Open one random wall on the shared edge.
+      tTile = getTile(ptMaze, iTilesW, iTile);
+      if (iDir == DIR_NORTH || iDir == DIR_SOUTH)
+        llCell = xy2cell(ptMaze, tTile.iX + randI(&ptMaze->tRand, tTile.iW),
+                         (iDir == DIR_NORTH) ? tTile.iY : tTile.iY + tTile.iH - 1);
+      else
+        llCell = xy2cell(ptMaze, (iDir == DIR_WEST) ? tTile.iX : tTile.iX + tTile.iW - 1,
+                         tTile.iY + randI(&ptMaze->tRand, tTile.iH));
+      breakWall(ptMaze, iDir, llCell);
+
+      pui8Vis[iNext]    = 1;
+      piStack[iStack++] = iNext;
+      iFound            = 1;
+    }
+
+    if (! iFound) --iStack;
+  }
+
+  free(piStack);
+  free(pui8Vis);
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  generateTiles
+ * Purpose: Carves TILE_SIZE tiles on all threads and joins them into one
+ *          perfect maze. Returns a random cell and direction as starting point.
+ *******************************************************************************/
+int generateTiles(t_maze* ptMaze, ll* pllCell) {
+  t_tiles tTiles = {0};
+
+  tTiles.ptMaze  = ptMaze;
+  tTiles.iTilesW = (ptMaze->iMazeW + TILE_SIZE - 1) / TILE_SIZE;
+  tTiles.iTilesH = (ptMaze->iMazeH + TILE_SIZE - 1) / TILE_SIZE;
+
+  ptMaze->bShared = ptMaze->bLarge && ptMaze->iThreads > 1;
+  runThreads(ptMaze, tileWorker, &tTiles);
+  ptMaze->bShared = 0;
+
+  if (tTiles.bFailed) return -1;
+  if (! joinTiles(ptMaze, tTiles.iTilesW, tTiles.iTilesH)) return -1;
+
+  *pllCell = xy2cell(ptMaze, randIab(&ptMaze->tRand, 1, ptMaze->iMazeW + 1),
+                             randIab(&ptMaze->tRand, 1, ptMaze->iMazeH + 1));
+  return randBits(&ptMaze->tRand, 2);
+}
+
+/*******************************************************************************
+ * Name:  kruskalWorker
+ * Purpose: Thread for one pass of the shuffle. Every edge gets a random bucket
+ *          and each bucket is shuffled alone. Chunks and buckets have their own
+ *          random sequences, so the order doesn't depend on the threads.
+ *******************************************************************************/
+void* kruskalWorker(void* pvKruskal) {
+  t_kruskal* ptKruskal  = (t_kruskal*) pvKruskal;
+  t_maze*    ptMaze     = ptKruskal->ptMaze;
+  uint32_t*  pui32Count = NULL;
+  uint32_t*  pui32Edge  = ptKruskal->pui32Edge;
+  uint32_t   ui32Swap   = 0;
+  t_rand     tRand      = {0};
+  int        iJobs      = 0;
+  int        iJob       = 0;
+  int        iX         = 0;
+  int        iY         = 0;
+  ll         llSlot     = 0;
+  ll         llEnd      = 0;
+  ll         llJ        = 0;
+
+  iJobs = (ptKruskal->iPass == KRUSKAL_SHUFFLE) ? KRUSKAL_BUCKETS : ptKruskal->iChunks;
+
+  while ((iJob = __atomic_fetch_add(&ptKruskal->iNext, 1, __ATOMIC_RELAXED)) < iJobs) {
+    // Fisher-Yates within a bucket.
+    if (ptKruskal->iPass == KRUSKAL_SHUFFLE) {
+      randSeed(&tRand, (uint64_t) ptMaze->llSeed + 0xbf58476d1ce4e5b9ULL * (iJob + 1));
+      llSlot = ptKruskal->llStart[iJob];
+      for (ll i = ptKruskal->llStart[iJob + 1] - 1; i > llSlot; --i) {
+        llJ            = llSlot + randI(&tRand, i - llSlot + 1);
+        ui32Swap       = pui32Edge[i];
+        pui32Edge[i]   = pui32Edge[llJ];
+        pui32Edge[llJ] = ui32Swap;
+      }
+      continue;
+    }
+
+    // Count and scatter draw the same buckets for the edges of a chunk.
+    randSeed(&tRand, (uint64_t) ptMaze->llSeed + 0x94d049bb133111ebULL * (iJob + 1));
+    pui32Count = ptKruskal->pui32Count + (ll) iJob * KRUSKAL_BUCKETS;
+    llSlot     = (ll) iJob * KRUSKAL_CHUNK;
+    llEnd      = llSlot + KRUSKAL_CHUNK;
+    if (llEnd > ptKruskal->llSlots) llEnd = ptKruskal->llSlots;
+    iX         = (int) ((llSlot >> 1) % ptMaze->iMazeW);
+    iY         = (int) ((llSlot >> 1) / ptMaze->iMazeW);
+
+    for (; llSlot < llEnd; llSlot += 2) {
+      // East wall, if not at the east border ...
+      if (iX != ptMaze->iMazeW - 1) {
+        if (ptKruskal->iPass == KRUSKAL_COUNT) ++pui32Count[randBits(&tRand, 8)];
+        else pui32Edge[pui32Count[randBits(&tRand, 8)]++] = (uint32_t) llSlot;
+      }
+      // ... and south wall, if not at the south border.
+      if (iY != ptMaze->iMazeH - 1) {
+        if (ptKruskal->iPass == KRUSKAL_COUNT) ++pui32Count[randBits(&tRand, 8)];
+        else pui32Edge[pui32Count[randBits(&tRand, 8)]++] = (uint32_t) llSlot | 1;
+      }
+      if (++iX == ptMaze->iMazeW) {
+        iX = 0;
+        ++iY;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/*******************************************************************************
+ * Name:  kruskalFind
+ * Purpose: Union find root with full path compression.
+ *******************************************************************************/
+uint32_t kruskalFind(uint32_t* pui32Parent, uint32_t ui32Cell) {
+  uint32_t ui32Root = ui32Cell;
+  uint32_t ui32Next = 0;
+
+  while (pui32Parent[ui32Root] != ui32Root)
+    ui32Root = pui32Parent[ui32Root];
+
+  while (pui32Parent[ui32Cell] != ui32Root) {
+    ui32Next              = pui32Parent[ui32Cell];
+    pui32Parent[ui32Cell] = ui32Root;
+    ui32Cell              = ui32Next;
+  }
+
+  return ui32Root;
+}
+
+/*******************************************************************************
+ * Name:  generateKruskal
+ * Purpose: Breaks the walls in random order if they join two different sets.
+ *          Returns a random cell and direction as starting point, or -1 if
+ *          out of memory.
+ *******************************************************************************/
+int generateKruskal(t_maze* ptMaze, ll* pllCell) {
+  t_kruskal tKruskal    = {0};
+  uint32_t* pui32Parent = NULL;
+  uint8_t*  pui8Rank    = NULL;
+  uint32_t  ui32A       = 0;
+  uint32_t  ui32B       = 0;
+  uint32_t  ui32Edge    = 0;
+  uint32_t  ui32Off     = 0;
+  ll        llJoins     = ptMaze->llMazeCount - 1;
+  ll        llEdges     = 0;
+
+  tKruskal.ptMaze     = ptMaze;
+  tKruskal.llSlots    = ptMaze->llMazeCount * 2;
+  tKruskal.iChunks    = (int) ((tKruskal.llSlots + KRUSKAL_CHUNK - 1) / KRUSKAL_CHUNK);
+  llEdges             = tKruskal.llSlots - ptMaze->iMazeW - ptMaze->iMazeH;
+  tKruskal.pui32Edge  = (uint32_t*) malloc((llEdges + 1) * sizeof(uint32_t));
+  tKruskal.pui32Count = (uint32_t*) calloc((ll) tKruskal.iChunks * KRUSKAL_BUCKETS, sizeof(uint32_t));
+  pui32Parent         = (uint32_t*) malloc(ptMaze->llMazeCount * sizeof(uint32_t));
+  pui8Rank            = (uint8_t*)  calloc(ptMaze->llMazeCount, sizeof(uint8_t));
+
+  if (tKruskal.pui32Edge == NULL || tKruskal.pui32Count == NULL ||
+      pui32Parent == NULL || pui8Rank == NULL) {
+    free(tKruskal.pui32Edge);
+    free(tKruskal.pui32Count);
+    free(pui32Parent);
+    free(pui8Rank);
+    return -1;
+  }
+
+  // Count edges per chunk and bucket ...
+  tKruskal.iPass = KRUSKAL_COUNT;
+  runThreads(ptMaze, kruskalWorker, &tKruskal);
+
+  // ... turn counts into offsets, buckets one after another ...
+  for (int b = 0; b < KRUSKAL_BUCKETS; ++b) {
+    tKruskal.llStart[b] = ui32Off;
+    for (int c = 0; c < tKruskal.iChunks; ++c) {
+      ui32Edge = tKruskal.pui32Count[(ll) c * KRUSKAL_BUCKETS + b];
+      tKruskal.pui32Count[(ll) c * KRUSKAL_BUCKETS + b] = ui32Off;
+      ui32Off += ui32Edge;
+    }
+  }
+  tKruskal.llStart[KRUSKAL_BUCKETS] = ui32Off;
+
+  // ... scatter them and shuffle each bucket.
+  tKruskal.iPass = KRUSKAL_SCATTER;
+  tKruskal.iNext = 0;
+  runThreads(ptMaze, kruskalWorker, &tKruskal);
+  tKruskal.iPass = KRUSKAL_SHUFFLE;
+  tKruskal.iNext = 0;
+  runThreads(ptMaze, kruskalWorker, &tKruskal);
+
+  for (ll i = 0; i < ptMaze->llMazeCount; ++i)
+    pui32Parent[i] = (uint32_t) i;
+
+  // One sequential scan, stops as soon as all cells are in one set.
+  for (ll i = 0; i < llEdges && llJoins != 0; ++i) {
+    ui32Edge = tKruskal.pui32Edge[i];
+    ui32A    = kruskalFind(pui32Parent, ui32Edge >> 1);
+    ui32B    = kruskalFind(pui32Parent, (ui32Edge >> 1) + ((ui32Edge & 1) ? ptMaze->iMazeW : 1));
+    if (ui32A == ui32B) continue;
+
+    // Union by rank.
+    if (pui8Rank[ui32A] < pui8Rank[ui32B]) pui32Parent[ui32A] = ui32B;
+    else if (pui8Rank[ui32A] > pui8Rank[ui32B]) pui32Parent[ui32B] = ui32A;
+    else {
+      pui32Parent[ui32B] = ui32A;
+      ++pui8Rank[ui32A];
+    }
+
+    breakWall(ptMaze, (ui32Edge & 1) ? DIR_SOUTH : DIR_EAST,
+              xy2cell(ptMaze, (ui32Edge >> 1) % ptMaze->iMazeW + 1, (ui32Edge >> 1) / ptMaze->iMazeW + 1));
+    --llJoins;
+  }
+
+  free(tKruskal.pui32Edge);
+  free(tKruskal.pui32Count);
+  free(pui32Parent);
+  free(pui8Rank);
+
+  *pllCell = xy2cell(ptMaze, randIab(&ptMaze->tRand, 1, ptMaze->iMazeW + 1),
+                             randIab(&ptMaze->tRand, 1, ptMaze->iMazeH + 1));
+  return randBits(&ptMaze->tRand, 2);
+}
+
+/*******************************************************************************
+ * Name:  setWalkDir
+ * Purpose: Stores the direction a walk left a cell, 2 bits per grid cell.
+ *******************************************************************************/
+void setWalkDir(uint8_t* pui8Walk, ll llCell, int iDir) {
+  int iShift = (llCell & 3) << 1;
+  pui8Walk[llCell >> 2] = (pui8Walk[llCell >> 2] & ~(3 << iShift)) | iDir << iShift;
+}
+
+/*******************************************************************************
+ * Name:  getWalkDir
+ * Purpose: Gets the direction a walk left a cell the last time.
+ *******************************************************************************/
+int getWalkDir(uint8_t* pui8Walk, ll llCell) {
+  return (pui8Walk[llCell >> 2] >> ((llCell & 3) << 1)) & 3;
+}
+
+/*******************************************************************************
+ * Name:  walkStep
+ * Purpose: Random step to one of the neighbours inside of the maze. Returns
+ *          the direction and updates the coordinates.
+ *******************************************************************************/
+int walkStep(t_maze* ptMaze, int* piX, int* piY) {
+  int iDir = 0;
+
+  // Draw again while the step would leave the maze.
+  while (1) {
+    iDir = randBits(&ptMaze->tRand, 2);
+    if (iDir == DIR_NORTH && *piY > 1)              { --*piY; break; }
+    if (iDir == DIR_SOUTH && *piY < ptMaze->iMazeH) { ++*piY; break; }
+    if (iDir == DIR_WEST  && *piX > 1)              { --*piX; break; }
+    if (iDir == DIR_EAST  && *piX < ptMaze->iMazeW) { ++*piX; break; }
+  }
+
+  return iDir;
+}
+
+/*******************************************************************************
+ * Name:  generateWilson
+ * Purpose: Uniform spanning tree rooted at the exit. Loop erased random walks
+ *          from each cell not yet in the tree until they hit it. A walk only
+ *          keeps the last direction out of each cell, so loops vanish by
+ *          overwriting. Returns a random cell and direction as starting point,
+ *          or -1 if out of memory.
+ *******************************************************************************/
+int generateWilson(t_maze* ptMaze, ll* pllCell) {
+  uint8_t* pui8Walk  = (uint8_t*) malloc((ptMaze->llGridCount >> 2) + 1);
+  ll       llCell    = 0;
+  ll       llNext    = 0;
+  int      iDir      = 0;
+  int      iX        = 0;
+  int      iY        = 0;
+  int      bNextFree = 0;
+
+  if (pui8Walk == NULL) return -1;
+
+  // The exit is the root, cells are in the tree as soon as a wall is broken.
+  for (int y = 1; y < ptMaze->iMazeH + 1; ++y) {
+    for (int x = 1; x < ptMaze->iMazeW + 1; ++x) {
+      if (! isCellWhole(ptMaze, xy2cell(ptMaze, x, y))) continue;
+
+      // Walk until the tree is hit ...
+      llCell = xy2cell(ptMaze, x, y);
+      iX     = x;
+      iY     = y;
+      while (isCellWhole(ptMaze, llCell)) {
+        iDir = walkStep(ptMaze, &iX, &iY);
+        setWalkDir(pui8Walk, llCell, iDir);
+        llCell = getCellInDir(ptMaze, iDir, llCell);
+      }
+
+      // ... and break the walls along the last way out of each cell.
+      llCell = xy2cell(ptMaze, x, y);
+      do {
+        iDir      = getWalkDir(pui8Walk, llCell);
+        llNext    = getCellInDir(ptMaze, iDir, llCell);
+        bNextFree = isCellWhole(ptMaze, llNext);
+        breakWall(ptMaze, iDir, llCell);
+        llCell    = llNext;
+      } while (bNextFree);
+    }
+  }
+
+  free(pui8Walk);
+
+  *pllCell = xy2cell(ptMaze, randIab(&ptMaze->tRand, 1, ptMaze->iMazeW + 1),
+                             randIab(&ptMaze->tRand, 1, ptMaze->iMazeH + 1));
+  return randBits(&ptMaze->tRand, 2);
+}
+
+/*******************************************************************************
+ * Name:  spreadBits
+ * Purpose: Moves 32 bits to the even bits of a word, one per packed cell.
+ *******************************************************************************/
+uint64_t spreadBits(uint32_t ui32Bits) {
+  uint64_t ui64 = ui32Bits;
+
+  ui64 = (ui64 | ui64 << 16) & 0x0000ffff0000ffffULL;
+  ui64 = (ui64 | ui64 << 8)  & 0x00ff00ff00ff00ffULL;
+  ui64 = (ui64 | ui64 << 4)  & 0x0f0f0f0f0f0f0f0fULL;
+  ui64 = (ui64 | ui64 << 2)  & 0x3333333333333333ULL;
+  ui64 = (ui64 | ui64 << 1)  & PACK_EVEN;
+
+  return ui64;
+}
+
+/*******************************************************************************
+ * Name:  getCellsMask
+ * Purpose: Packed bits of the cells llFrom to llTo (inclusive) within a word.
+ *******************************************************************************/
+uint64_t getCellsMask(ll llWord, ll llFrom, ll llTo) {
+  ll llFirst = llWord << PACK_SHIFT;
+  ll llA     = (llFrom > llFirst) ? llFrom - llFirst : 0;
+  ll llB     = (llTo < llFirst + PACK_MASK) ? llTo - llFirst : PACK_MASK;
+
+  if (llB < llA) return 0;
+  return (~0ULL << (llA << 1)) & (~0ULL >> (63 - ((llB << 1) + 1)));
+}
+
+/*******************************************************************************
+ * Name:  getCellsBits
+ * Purpose: Same as getCellsMask(), but one bit per cell.
+ *******************************************************************************/
+uint32_t getCellsBits(ll llWord, ll llFrom, ll llTo) {
+  ll llFirst = llWord << PACK_SHIFT;
+  ll llA     = (llFrom > llFirst) ? llFrom - llFirst : 0;
+  ll llB     = (llTo < llFirst + PACK_MASK) ? llTo - llFirst : PACK_MASK;
+
+  if (llB < llA) return 0;
+  return (~0U << llA) & (~0U >> (PACK_MASK - llB));
+}
+
+/*******************************************************************************
+ * Name:  clearWord
+ * Purpose: Breaks the walls of a packed word's bits. Byte grids get the same
+ *          walls broken one by one, so both modes give the same maze.
+ *******************************************************************************/
+void clearWord(t_maze* ptMaze, ll llWord, uint64_t ui64Clear) {
+  int iBit = 0;
+
+  if (ptMaze->bLarge) {
+    ptMaze->pui64Packed[llWord] &= ~ui64Clear;
+    return;
+  }
+
+  while (ui64Clear) {
+    iBit = __builtin_ctzll(ui64Clear);
+    breakWall(ptMaze, (iBit & 1) ? DIR_EAST : DIR_SOUTH, (llWord << PACK_SHIFT) + (iBit >> 1));
+    ui64Clear &= ui64Clear - 1;
+  }
+}
+
+/*******************************************************************************
+ * Name:  carveBinaryRow
+ * Purpose: Every cell opens south or east by a random bit, 32 cells at once.
+ *          The last row can only go east, the last column only south.
+ *******************************************************************************/
+void carveBinaryRow(t_maze* ptMaze, int iY) {
+  ll       llFirst = xy2cell(ptMaze, 1, iY);
+  ll       llLast  = llFirst + ptMaze->iMazeW - 1;
+  uint64_t ui64S   = 0;
+
+  for (ll w = llFirst >> PACK_SHIFT; w <= llLast >> PACK_SHIFT; ++w) {
+    ui64S = (iY == ptMaze->iMazeH) ? 0 : spreadBits((uint32_t) randBits(&ptMaze->tRand, 32));
+    clearWord(ptMaze, w, (ui64S | (~ui64S & PACK_EVEN) << 1) & getCellsMask(w, llFirst, llLast - 1));
+  }
+
+  if (iY != ptMaze->iMazeH)
+    clearWord(ptMaze, llLast >> PACK_SHIFT, (uint64_t) PACK_SOUTH << ((llLast & PACK_MASK) << 1));
+}
+
+/*******************************************************************************
+ * Name:  carveSidewinderRow
+ * Purpose: Random bits open the row to the east, 32 cells at once. A cleared
+ *          bit ends a run and one random cell of the run opens south. The last
+ *          row is one corridor.
+ *******************************************************************************/
+void carveSidewinderRow(t_maze* ptMaze, int iY) {
+  ll       llFirst = xy2cell(ptMaze, 1, iY);
+  ll       llLast  = llFirst + ptMaze->iMazeW - 1;
+  ll       llRun   = llFirst;
+  ll       llEnd   = 0;
+  uint32_t ui32E   = 0;
+  uint32_t ui32End = 0;
+  uint32_t ui32S   = 0;
+  uint64_t ui64Run = 0;
+
+  for (ll w = llFirst >> PACK_SHIFT; w <= llLast >> PACK_SHIFT; ++w) {
+    ui32E = (iY == ptMaze->iMazeH) ? ~0U : (uint32_t) randBits(&ptMaze->tRand, 32);
+    clearWord(ptMaze, w, spreadBits(ui32E) << 1 & getCellsMask(w, llFirst, llLast - 1));
+    if (iY == ptMaze->iMazeH) continue;
+
+    // Walk the run ends of this word, the last cell always ends one.
+    ui32End = ~ui32E & getCellsBits(w, llFirst, llLast);
+    if ((llLast >> PACK_SHIFT) == w) ui32End |= 1U << (llLast & PACK_MASK);
+
+    // South walls of this word are collected, runs from former words rarely
+    // open there.
+    ui32S = 0;
+    while (ui32End) {
+      llEnd   = (w << PACK_SHIFT) + __builtin_ctz(ui32End);
+      ui64Run = (uint64_t) (uint32_t) randBits(&ptMaze->tRand, 32) * (uint64_t) (llEnd - llRun + 1);
+      llRun  += ui64Run >> 32;
+      if ((llRun >> PACK_SHIFT) == w) ui32S |= 1U << (llRun & PACK_MASK);
+      else clearWord(ptMaze, llRun >> PACK_SHIFT, (uint64_t) PACK_SOUTH << ((llRun & PACK_MASK) << 1));
+      llRun   = llEnd + 1;
+      ui32End &= ui32End - 1;
+    }
+    clearWord(ptMaze, w, spreadBits(ui32S));
+  }
+}
+
+/*******************************************************************************
+ * Name:  generateRows
+ * Purpose: Binary tree or sidewinder, row by row. Returns a random cell and
+ *          direction as starting point.
+ *******************************************************************************/
+int generateRows(t_maze* ptMaze, ll* pllCell) {
+  for (int y = 1; y < ptMaze->iMazeH + 1; ++y) {
+    if (ptMaze->iAlgo == ALGO_BINARY) carveBinaryRow(ptMaze, y);
+    else                              carveSidewinderRow(ptMaze, y);
+  }
+
+  *pllCell = xy2cell(ptMaze, randIab(&ptMaze->tRand, 1, ptMaze->iMazeW + 1),
+                             randIab(&ptMaze->tRand, 1, ptMaze->iMazeH + 1));
+  return randBits(&ptMaze->tRand, 2);
+}
+
+/*******************************************************************************
+ * Name:  pickActive
+ * Purpose: Index of the active cell to go on from, [llHead, llTail) are active.
+ *******************************************************************************/
+ll pickActive(t_maze* ptMaze, ll llHead, ll llTail) {
+  int iPolicy = ptMaze->iPolicy;
+
+  if (iPolicy == POLICY_MIX)
+    iPolicy = (randI(&ptMaze->tRand, 100) < ptMaze->iMix) ? POLICY_RANDOM : POLICY_NEWEST;
+
+  if (iPolicy == POLICY_RANDOM) return llHead + randI(&ptMaze->tRand, llTail - llHead);
+  if (iPolicy == POLICY_OLDEST) return llHead;
+  return llTail - 1;
+}
+
+/*******************************************************************************
+ * Name:  generateGrowing
+ * Purpose: Growing tree with its own array of cells. Cells are added at the tail
+ *          and removed in O(1), the newest and oldest by moving the tail or
+ *          head, any other by swapping in the tail. Returns the last cell and
+ *          direction as starting point, or -1 if out of memory.
+ *******************************************************************************/
+int generateGrowing(t_maze* ptMaze, ll* pllCell) {
+  ll* pllActive = (ll*) malloc(ptMaze->llMazeCount * sizeof(ll));
+  ll  llHead    = 0;
+  ll  llTail    = 0;
+  ll  llPick    = 0;
+  ll  llCell    = ptMaze->llExit;
+  int iDir      = turnBack(ptMaze->iExitDir);
+
+  if (pllActive == NULL) return -1;
+
+  pllActive[llTail++] = llCell;
+  *pllCell             = llCell;
+  initAround(ptMaze);
+
+  while (llHead != llTail) {
+    llPick = pickActive(ptMaze, llHead, llTail);
+    llCell = pllActive[llPick];
+
+    if (isACellAroundWhole(ptMaze, &iDir, llCell)) {
+      breakIntoCell(ptMaze, iDir, &llCell);
+      pllActive[llTail++] = llCell;
+      *pllCell = llCell;
+      continue;
+    }
+
+    // No whole cell left around, drop it from the active ones.
+    if      (llPick == llTail - 1) --llTail;
+    else if (llPick == llHead)     ++llHead;
+    else    pllActive[llPick] = pllActive[--llTail];
+  }
+
+  free(pllActive);
+  freeAround(ptMaze);
+
+  return iDir;
+}
+
+/*******************************************************************************
+ * Name:  ellerFree
+ * Purpose: Frees the row arrays of Eller's generator.
+ *******************************************************************************/
+void ellerFree(t_eller* ptEller) {
+  free(ptEller->pui32Set);
+  free(ptEller->pui32Root);
+  free(ptEller->pui32Left);
+  free(ptEller->pui8Down);
+  free(ptEller->pui8East);
+  free(ptEller->pui8South);
+  memset(ptEller, 0, sizeof(t_eller));
+}
+
+/*******************************************************************************
+ * Name:  ellerInit
+ * Purpose: Allocates the row arrays and puts every cell of the first row into
+ *          its own set. Returns 0 if there is not enough memory.
+ *******************************************************************************/
+int ellerInit(t_eller* ptEller, int iW) {
+  memset(ptEller, 0, sizeof(t_eller));
+
+  ptEller->iW        = iW;
+  ptEller->pui32Set  = (uint32_t*) malloc(iW * sizeof(uint32_t));
+  ptEller->pui32Root = (uint32_t*) malloc(iW * sizeof(uint32_t));
+  ptEller->pui32Left = (uint32_t*) malloc(iW * sizeof(uint32_t));
+  ptEller->pui8Down  = (uint8_t*)  malloc(iW * sizeof(uint8_t));
+  ptEller->pui8East  = (uint8_t*)  malloc(iW * sizeof(uint8_t));
+  ptEller->pui8South = (uint8_t*)  malloc(iW * sizeof(uint8_t));
+
+  if (ptEller->pui32Set  == NULL || ptEller->pui32Root == NULL ||
+      ptEller->pui32Left == NULL || ptEller->pui8Down  == NULL ||
+      ptEller->pui8East  == NULL || ptEller->pui8South == NULL) {
+    ellerFree(ptEller);
+    return 0;
+  }
+
+  for (int x = 0; x < iW; ++x)
+    ptEller->pui32Set[x] = x;
+
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  ellerFind
+ * Purpose: Union find root of a set with path halving.
+ *******************************************************************************/
+uint32_t ellerFind(uint32_t* pui32Root, uint32_t ui32Set) {
+  while (pui32Root[ui32Set] != ui32Set)
+    ui32Set = pui32Root[ui32Set] = pui32Root[pui32Root[ui32Set]];
+  return ui32Set;
+}
+
+/*******************************************************************************
+ * Name:  ellerRow
+ * Purpose: Carves the next row. Afterwards pui8East and pui8South hold the
+ *          walls of the row and pui32Set the sets of the row below.
+ *******************************************************************************/
+void ellerRow(t_eller* ptEller, t_rand* ptRand, int bLast) {
+  uint32_t* pui32Set  = ptEller->pui32Set;
+  uint32_t* pui32Root = ptEller->pui32Root;
+  uint32_t* pui32Left = ptEller->pui32Left;
+  uint8_t*  pui8Down  = ptEller->pui8Down;
+  uint32_t  ui32A     = 0;
+  uint32_t  ui32B     = 0;
+  uint32_t  ui32Free  = 0;
+  int       iW        = ptEller->iW;
+
+  // Set numbers are below the width, each one starts as its own root.
+  for (int x = 0; x < iW; ++x) {
+    pui32Root[x] = x;
+    pui32Left[x] = 0;
+    pui8Down[x]  = 0;
+  }
+
+  // Join neighbours of different sets at random, the last row joins them all.
+  for (int x = 0; x < iW - 1; ++x) {
+    ui32A = ellerFind(pui32Root, pui32Set[x]);
+    ui32B = ellerFind(pui32Root, pui32Set[x + 1]);
+    ptEller->pui8East[x] = ! (ui32A != ui32B && (bLast || randBits(ptRand, 1)));
+    if (! ptEller->pui8East[x]) pui32Root[ui32B] = ui32A;
+  }
+  ptEller->pui8East[iW - 1] = 1;
+
+  if (bLast) {
+    memset(ptEller->pui8South, 1, iW);
+    return;
+  }
+
+  for (int x = 0; x < iW; ++x) {
+    pui32Set[x] = ellerFind(pui32Root, pui32Set[x]);
+    ++pui32Left[pui32Set[x]];
+  }
+
+  // Go south at random, but at least once per set.
+  for (int x = 0; x < iW; ++x) {
+    ui32A = pui32Set[x];
+    --pui32Left[ui32A];
+    ptEller->pui8South[x] = ! (randBits(ptRand, 1) || (pui32Left[ui32A] == 0 && ! pui8Down[ui32A]));
+    if (! ptEller->pui8South[x]) pui8Down[ui32A] = 1;
+  }
+
+  // Walled in cells start new sets, numbers of sets that ended are free again.
+  for (int x = 0; x < iW; ++x) {
+    if (! ptEller->pui8South[x]) continue;
+    while (pui8Down[ui32Free]) ++ui32Free;
+    pui32Set[x]        = ui32Free;
+    pui8Down[ui32Free] = 1;
+  }
+}
+
+/*******************************************************************************
+ * Name:  generateEller
+ * Purpose: Carves the grid row by row with Eller's algorithm. Returns a random
+ *          cell and direction as starting point, or -1 if out of memory.
+ *******************************************************************************/
+int generateEller(t_maze* ptMaze, ll* pllCell) {
+  t_eller tEller = {0};
+  ll      llCell = 0;
+
+  if (! ellerInit(&tEller, ptMaze->iMazeW)) return -1;
+
+  for (int y = 1; y < ptMaze->iMazeH + 1; ++y) {
+    ellerRow(&tEller, &ptMaze->tRand, y == ptMaze->iMazeH);
+    llCell = xy2cell(ptMaze, 1, y);
+    for (int x = 0; x < ptMaze->iMazeW; ++x) {
+      if (! tEller.pui8East[x])  breakWall(ptMaze, DIR_EAST,  llCell + x);
+      if (! tEller.pui8South[x]) breakWall(ptMaze, DIR_SOUTH, llCell + x);
+    }
+  }
+
+  ellerFree(&tEller);
+
+  *pllCell = xy2cell(ptMaze, randIab(&ptMaze->tRand, 1, ptMaze->iMazeW + 1),
+                             randIab(&ptMaze->tRand, 1, ptMaze->iMazeH + 1));
+  return randBits(&ptMaze->tRand, 2);
+}
+
+/*******************************************************************************
+ * Name:  pickExit
+ * Purpose: Gets a random cell at the edge for the exit. Returns the direction
+ *          pointing into the maze, the exit is in the opposite one.
+ *******************************************************************************/
+int pickExit(t_maze* ptMaze, int* piX, int* piY) {
+  int iDir = 0;
+
+  // Get an entry cell a the edge.
+  //   X 1   2   3
+  // Y +---+---+---+
+  // 1 |   |   |   |       N
+  //   +---+---+---+       |
   // 2 |   |   |   |   W --+-- E
   //   +---+---+---+       |
   // 3 |   |   |   |       S
   //   +---+---+---+
-  iX   = randIab(1, g_tOpts.iMazeW + 1);
-  iY   = randIab(1, g_tOpts.iMazeH + 1);
-  iDir = randI(DIR_MOD);
+  *piX = randIab(&ptMaze->tRand, 1, ptMaze->iMazeW + 1);
+  *piY = randIab(&ptMaze->tRand, 1, ptMaze->iMazeH + 1);
+  iDir = randBits(&ptMaze->tRand, 2);
+
+  // Get the right edge for the starting cell.
+  if (iDir == DIR_NORTH) *piY = ptMaze->iMazeH;    // South border
+  if (iDir == DIR_WEST)  *piX = ptMaze->iMazeW;    // East  border
+  if (iDir == DIR_SOUTH) *piY = 1;                 // North border
+  if (iDir == DIR_EAST)  *piX = 1;                 // West  border
+
+  return iDir;
+}
+
+/*******************************************************************************
+ * Name:  streamMaze
+ * Purpose: Writes an Eller maze row by row as soon as a row is carved, without
+ *          any grid. Same text as exportMaze() of the same maze. Returns 0 if
+ *          there is not enough memory.
+ *******************************************************************************/
+int streamMaze(FILE* hFile, int iMazeW, int iMazeH, ll llSeed) {
+  t_maze  tMaze    = {0};
+  t_eller tEller   = {0};
+  char*   pcLine   = (char*) malloc(4 * (size_t) iMazeW + 2);
+  char*   pc       = NULL;
+  int     iExitX   = 0;
+  int     iExitY   = 0;
+  int     iExitDir = 0;
+
+  if (pcLine == NULL) return 0;
+  if (! ellerInit(&tEller, iMazeW)) {
+    free(pcLine);
+    return 0;
+  }
+
+  // Only size and random generator are needed to draw the same exit.
+  tMaze.iMazeW = iMazeW;
+  tMaze.iMazeH = iMazeH;
+  mazeReseed(&tMaze, llSeed);
+  iExitDir = turnBack(pickExit(&tMaze, &iExitX, &iExitY));
+
+  pc    = pcLine;
+  *pc++ = '+';
+  for (int x = 1; x < iMazeW + 1; ++x, pc += 4)
+    memcpy(pc, (iExitDir == DIR_NORTH && x == iExitX) ? "   +" : "---+", 4);
+  *pc++ = '\n';
+  fwrite(pcLine, 1, pc - pcLine, hFile);
+
+  for (int y = 1; y < iMazeH + 1; ++y) {
+    ellerRow(&tEller, &tMaze.tRand, y == iMazeH);
+
+    pc    = pcLine;
+    *pc++ = (iExitDir == DIR_WEST && y == iExitY) ? ' ' : '|';
+    for (int x = 0; x < iMazeW; ++x, pc += 4)
+      memcpy(pc, tEller.pui8East[x] ? "   |" : "    ", 4);
+    if (iExitDir == DIR_EAST && y == iExitY) pc[-1] = ' ';
+    *pc++ = '\n';
+    fwrite(pcLine, 1, pc - pcLine, hFile);
+
+    pc    = pcLine;
+    *pc++ = '+';
+    for (int x = 0; x < iMazeW; ++x, pc += 4)
+      memcpy(pc, tEller.pui8South[x] ? "---+" : "   +", 4);
+    if (iExitDir == DIR_SOUTH && y == iExitY) memcpy(pcLine + 1 + 4 * (iExitX - 1), "   +", 4);
+    *pc++ = '\n';
+    fwrite(pcLine, 1, pc - pcLine, hFile);
+  }
+
+  ellerFree(&tEller);
+  free(pcLine);
+
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  carveMaze
+ * Purpose: Carves a perfect maze within the border of the grid. Returns the
+ *          direction and the cell to start from, or -1 if out of memory.
+ *******************************************************************************/
+int carveMaze(t_maze* ptMaze, ll* pllCell, int bAnimate) {
+  ll  llCell = 0;
+  int iDir   = 0;
+  int iX     = 0;
+  int iY     = 0;
+
+  // Init the grid's cells and the border.
+  initGrid(ptMaze);
+
+  // Get the exit and save its cell for future use ;o) ...
+  iDir   = pickExit(ptMaze, &iX, &iY);
+  llCell = xy2cell(ptMaze, iX, iY);
+
+  ptMaze->llExit   = llCell;
+  ptMaze->iExitDir = turnBack(iDir);
+
+  // Tiles only carve into whole cells, so the exit comes last there.
+  if (ptMaze->iAlgo == ALGO_TILES) {
+    iDir = generateTiles(ptMaze, pllCell);
+    breakWall(ptMaze, ptMaze->iExitDir, ptMaze->llExit);
+    return iDir;
+  }
+
+  // ... and break the first wall in appropriate border for the exit.
+  breakWall(ptMaze, ptMaze->iExitDir, llCell);
+
+  if (ptMaze->iAlgo == ALGO_ELLER)
+    return generateEller(ptMaze, pllCell);
+  if (ptMaze->iAlgo == ALGO_KRUSKAL)
+    return generateKruskal(ptMaze, pllCell);
+  if (ptMaze->iAlgo == ALGO_WILSON)
+    return generateWilson(ptMaze, pllCell);
+  if (ptMaze->iAlgo == ALGO_BINARY || ptMaze->iAlgo == ALGO_SIDEWIND)
+    return generateRows(ptMaze, pllCell);
+  if (ptMaze->iAlgo == ALGO_GROWING)
+    return generateGrowing(ptMaze, pllCell);
+
+  return generateBacktrack(ptMaze, llCell, iDir, pllCell, bAnimate);
+}
+
+/*******************************************************************************
+ * Name:  braidMaze
+ * Purpose: Opens iBraid percent of the dead ends to a random neighbour, each
+ *          one adds a loop to the maze.
+ *******************************************************************************/
+void braidMaze(t_maze* ptMaze) {
+  ll  llCell  = 0;
+  int iWalls  = 0;
+  int iPick   = 0;
+
+  for (int y = 1; y <= ptMaze->iMazeH; ++y) {
+    for (int x = 1; x <= ptMaze->iMazeW; ++x) {
+      llCell = xy2cell(ptMaze, x, y);
+      iWalls = getCellWalls(ptMaze, llCell) & CELL_WHOLE;
+      if (__builtin_popcount(iWalls) != 3 || llCell == ptMaze->llExit) continue;
+      if (randI(&ptMaze->tRand, 100) >= ptMaze->iBraid) continue;
+
+      // Only walls to other cells, never the border.
+      if (y == 1)             iWalls &= ~CELL_NORTH;
+      if (x == 1)             iWalls &= ~CELL_WEST;
+      if (y == ptMaze->iMazeH) iWalls &= ~CELL_SOUTH;
+      if (x == ptMaze->iMazeW) iWalls &= ~CELL_EAST;
+      if (iWalls == 0) continue;
+
+      for (iPick = randI(&ptMaze->tRand, __builtin_popcount(iWalls)); iPick > 0; --iPick)
+        iWalls &= iWalls - 1;
+      breakWall(ptMaze, __builtin_ctz(iWalls), llCell);
+    }
+  }
+}
+
+/*******************************************************************************
+ * Name:  generateMaze
+ * Purpose: Generates a complete maze within the border of the grid, braided
+ *          if wanted. Returns the direction and the cell to start from, or -1
+ *          if out of memory.
+ *******************************************************************************/
+int generateMaze(t_maze* ptMaze, ll* pllCell, int bAnimate) {
+  int iDir = carveMaze(ptMaze, pllCell, bAnimate);
+
+  if (iDir != -1 && ptMaze->iBraid != 0) braidMaze(ptMaze);
+
+  // New walls, the screen's grid is outdated.
+  ptMaze->tFrame.bDrawn = 0;
+  return iDir;
+}
+
+/*******************************************************************************
+ * Name:  floodCells
+ * Purpose: Breadth first search cell by cell through isWallInDir(). Returns
+ *          the steps from llFrom to llTo, or -1 if not reachable. Counts the
+ *          cells reached into *pllReached.
+ *******************************************************************************/
+ll floodCells(t_maze* ptMaze, ll llFrom, ll llTo, ll* pllReached) {
+  ll*      pllQueue = (ll*) malloc(ptMaze->llMazeCount * sizeof(ll));
+  uint8_t* pui8Seen = (uint8_t*) calloc(ptMaze->llGridCount, sizeof(uint8_t));
+  ll       llHead   = 0;
+  ll       llTail   = 0;
+  ll       llLayer  = 0;  // End of the current distance layer in the queue.
+  ll       llSteps  = 0;
+  ll       llCell   = 0;
+  ll       llNext   = 0;
+
+  *pllReached = 0;
+  if (pllQueue == NULL || pui8Seen == NULL) {
+    free(pllQueue);
+    free(pui8Seen);
+    return -1;
+  }
+
+  pllQueue[llTail++] = llFrom;
+  pui8Seen[llFrom]   = 1;
+  llLayer            = llTail;
+
+  while (llHead != llTail) {
+    if (llHead == llLayer) {
+      ++llSteps;
+      llLayer = llTail;
+    }
+    llCell = pllQueue[llHead++];
+    if (llCell == llTo) break;
+
+    for (int iDir = 0; iDir < DIR_MOD; ++iDir) {
+      if (isWallInDir(ptMaze, iDir, llCell)) continue;
+      llNext = getCellInDir(ptMaze, iDir, llCell);
+      if (pui8Seen[llNext] || isBorder(ptMaze, iDir, llCell)) continue;
+      pui8Seen[llNext]   = 1;
+      pllQueue[llTail++] = llNext;
+    }
+  }
+
+  *pllReached = llTail;
+  free(pllQueue);
+  free(pui8Seen);
+
+  return (llCell == llTo) ? llSteps : -1;
+}
+
+/*******************************************************************************
+ * Name:  boardFree
+ * Purpose: Frees all rows of a bitboard.
+ *******************************************************************************/
+void boardFree(t_board* ptBoard) {
+  free(ptBoard->pui64East);
+  free(ptBoard->pui64South);
+  free(ptBoard->pui64Seen);
+  free(ptBoard->pui64Front);
+  free(ptBoard->pui64Next);
+  free(ptBoard->piRows);
+  memset(ptBoard, 0, sizeof(t_board));
+}
+
+/*******************************************************************************
+ * Name:  boardLoad
+ * Purpose: Copies the walls of a maze into a bitboard of the same size.
+ *******************************************************************************/
+void boardLoad(t_board* ptBoard, t_maze* ptMaze) {
+  size_t sSize = (size_t) ptBoard->iH * ptBoard->iWords * sizeof(uint64_t);
+  ll     llRow = 0;
+
+  memset(ptBoard->pui64East,  0, sSize);
+  memset(ptBoard->pui64South, 0, sSize);
+
+  for (int y = 0; y < ptBoard->iH; ++y) {
+    llRow = xy2cell(ptMaze, 1, y + 1);
+    for (int x = 0; x < ptBoard->iW; ++x) {
+      if (isWallInDir(ptMaze, DIR_EAST, llRow + x))
+        ptBoard->pui64East[y * ptBoard->iWords + (x >> 6)]  |= 1ULL << (x & 63);
+      if (isWallInDir(ptMaze, DIR_SOUTH, llRow + x))
+        ptBoard->pui64South[y * ptBoard->iWords + (x >> 6)] |= 1ULL << (x & 63);
+    }
+  }
+}
+
+/*******************************************************************************
+ * Name:  boardInit
+ * Purpose: Copies the walls of a maze into a bitboard. Returns 0 if the maze
+ *          is wider than iMaxW or there is not enough memory.
+ *******************************************************************************/
+int boardInit(t_board* ptBoard, t_maze* ptMaze, int iMaxW) {
+  size_t sSize = 0;
+
+  memset(ptBoard, 0, sizeof(t_board));
+  if (ptMaze->iMazeW > iMaxW) return 0;
+
+  ptBoard->iW       = ptMaze->iMazeW;
+  ptBoard->iH       = ptMaze->iMazeH;
+  ptBoard->iWords   = (ptBoard->iW + 63) >> 6;
+  ptBoard->ui64Last = (ptBoard->iW & 63) ? (1ULL << (ptBoard->iW & 63)) - 1 : ~0ULL;
+
+  sSize               = (size_t) ptBoard->iH * ptBoard->iWords * sizeof(uint64_t);
+  ptBoard->pui64East  = (uint64_t*) calloc(1, sSize);
+  ptBoard->pui64South = (uint64_t*) calloc(1, sSize);
+  ptBoard->pui64Seen  = (uint64_t*) malloc(sSize);
+  ptBoard->pui64Front = (uint64_t*) malloc(sSize);
+  ptBoard->pui64Next  = (uint64_t*) malloc(sSize);
+  ptBoard->piRows     = (int*) malloc(2 * (ptBoard->iH + 1) * sizeof(int));
+
+  if (ptBoard->pui64East == NULL || ptBoard->pui64South == NULL || ptBoard->pui64Seen == NULL ||
+      ptBoard->pui64Front == NULL || ptBoard->pui64Next == NULL || ptBoard->piRows == NULL) {
+    boardFree(ptBoard);
+    return 0;
+  }
+
+  boardLoad(ptBoard, ptMaze);
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  boardRowStep
+ * Purpose: New cells of a row one step away from the front, all words at once.
+ *          Returns true if there are any.
+ *******************************************************************************/
+int boardRowStep(t_board* ptBoard, int y) {
+  int       iWords = ptBoard->iWords;
+  uint64_t* pui64E = ptBoard->pui64East  + y * iWords;
+  uint64_t* pui64F = ptBoard->pui64Front + y * iWords;
+  uint64_t* pui64S = ptBoard->pui64Seen  + y * iWords;
+  uint64_t  ui64   = 0;
+  uint64_t  ui64Any = 0;
+
+  for (int w = 0; w < iWords; ++w) {
+    // East through no east wall, west through no east wall of the cell to
+    // the west, carries cross the words.
+    ui64  = (pui64F[w] & ~pui64E[w]) << 1 | ((w > 0) ? (pui64F[w - 1] & ~pui64E[w - 1]) >> 63 : 0);
+    ui64 |= (pui64F[w] >> 1 | ((w < iWords - 1) ? pui64F[w + 1] << 63 : 0)) & ~pui64E[w];
+
+    // South from the row above, north from the row below.
+    if (y > 0)
+      ui64 |= pui64F[w - iWords] & ~ptBoard->pui64South[(y - 1) * iWords + w];
+    if (y < ptBoard->iH - 1)
+      ui64 |= pui64F[w + iWords] & ~ptBoard->pui64South[y * iWords + w];
+
+    if (w == iWords - 1) ui64 &= ptBoard->ui64Last;
+    ui64 &= ~pui64S[w];
+
+    ptBoard->pui64Next[y * iWords + w] = ui64;
+    pui64S[w] |= ui64;
+    ui64Any   |= ui64;
+  }
+
+  return ui64Any != 0;
+}
+
+/*******************************************************************************
+ * Name:  boardFlood
+ * Purpose: Breadth first search on a bitboard, each step moves the whole
+ *          front one cell in all directions with shifts and masks. Only rows
+ *          next to a front row are looked at. Takes maze coordinates, returns
+ *          the steps from one cell to the other, or -1 if not reachable.
+ *          Counts the cells reached into *pllReached.
+ *******************************************************************************/
+ll boardFlood(t_board* ptBoard, int iFromX, int iFromY, int iToX, int iToY, ll* pllReached) {
+  size_t    sSize   = (size_t) ptBoard->iH * ptBoard->iWords * sizeof(uint64_t);
+  int       iWords  = ptBoard->iWords;
+  int       iTo     = (iToY - 1) * iWords + ((iToX - 1) >> 6);
+  uint64_t  ui64To  = 1ULL << ((iToX - 1) & 63);
+  uint64_t* pui64T  = NULL;
+  int*      piRows  = ptBoard->piRows;
+  int*      piNext  = ptBoard->piRows + ptBoard->iH + 1;
+  int*      piT     = NULL;
+  int       iRows   = 1;
+  int       iNext   = 0;
+  int       iLast   = 0;
+  ll        llSteps = 0;
+
+  memset(ptBoard->pui64Seen,  0, sSize);
+  memset(ptBoard->pui64Front, 0, sSize);
+  memset(ptBoard->pui64Next,  0, sSize);
+
+  ptBoard->pui64Front[(iFromY - 1) * iWords + ((iFromX - 1) >> 6)] = 1ULL << ((iFromX - 1) & 63);
+  ptBoard->pui64Seen[(iFromY - 1) * iWords + ((iFromX - 1) >> 6)]  = 1ULL << ((iFromX - 1) & 63);
+  piRows[0] = iFromY - 1;
+
+  while (iRows != 0 && ! (ptBoard->pui64Seen[iTo] & ui64To)) {
+    ++llSteps;
+
+    // Front rows are ascending, so each neighbour row is stepped only once.
+    iNext = 0;
+    iLast = -1;
+    for (int i = 0; i < iRows; ++i) {
+      for (int y = piRows[i] - 1; y <= piRows[i] + 1; ++y) {
+        if (y < 0 || y >= ptBoard->iH || y <= iLast) continue;
+        iLast = y;
+        if (boardRowStep(ptBoard, y)) piNext[iNext++] = y;
+      }
+    }
+
+    // Old front rows are cleared, the new front takes their place.
+    for (int i = 0; i < iRows; ++i)
+      memset(ptBoard->pui64Front + piRows[i] * iWords, 0, iWords * sizeof(uint64_t));
+    pui64T              = ptBoard->pui64Front;
+    ptBoard->pui64Front = ptBoard->pui64Next;
+    ptBoard->pui64Next  = pui64T;
+    piT    = piRows;
+    piRows = piNext;
+    piNext = piT;
+    iRows  = iNext;
+  }
+
+  // Reached cells are counted once at the end.
+  *pllReached = 0;
+  for (ll i = 0; i < (ll) ptBoard->iH * iWords; ++i)
+    *pllReached += __builtin_popcountll(ptBoard->pui64Seen[i]);
+
+  return (ptBoard->pui64Seen[iTo] & ui64To) ? llSteps : -1;
+}
+
+/*******************************************************************************
+ * Name:  fillEast
+ * Purpose: Spreads cells to the east as long as there is no wall, 6 steps for
+ *          a whole word. ui64Open has the cells that can be entered from the
+ *          west.
+ *******************************************************************************/
+uint64_t fillEast(uint64_t ui64Fill, uint64_t ui64Open) {
+  ui64Fill |= ui64Open & (ui64Fill << 1);   ui64Open &= ui64Open << 1;
+  ui64Fill |= ui64Open & (ui64Fill << 2);   ui64Open &= ui64Open << 2;
+  ui64Fill |= ui64Open & (ui64Fill << 4);   ui64Open &= ui64Open << 4;
+  ui64Fill |= ui64Open & (ui64Fill << 8);   ui64Open &= ui64Open << 8;
+  ui64Fill |= ui64Open & (ui64Fill << 16);  ui64Open &= ui64Open << 16;
+  ui64Fill |= ui64Open & (ui64Fill << 32);
+  return ui64Fill;
+}
+
+/*******************************************************************************
+ * Name:  fillWest
+ * Purpose: Same as fillEast() to the west, ui64Open has the cells that can be
+ *          entered from the east.
+ *******************************************************************************/
+uint64_t fillWest(uint64_t ui64Fill, uint64_t ui64Open) {
+  ui64Fill |= ui64Open & (ui64Fill >> 1);   ui64Open &= ui64Open >> 1;
+  ui64Fill |= ui64Open & (ui64Fill >> 2);   ui64Open &= ui64Open >> 2;
+  ui64Fill |= ui64Open & (ui64Fill >> 4);   ui64Open &= ui64Open >> 4;
+  ui64Fill |= ui64Open & (ui64Fill >> 8);   ui64Open &= ui64Open >> 8;
+  ui64Fill |= ui64Open & (ui64Fill >> 16);  ui64Open &= ui64Open >> 16;
+  ui64Fill |= ui64Open & (ui64Fill >> 32);
+  return ui64Fill;
+}
+
+/*******************************************************************************
+ * Name:  boardFillRow
+ * Purpose: Spreads the seen cells of a row through all open east walls.
+ *******************************************************************************/
+void boardFillRow(t_board* ptBoard, int y) {
+  uint64_t* pui64E = ptBoard->pui64East + y * ptBoard->iWords;
+  uint64_t* pui64S = ptBoard->pui64Seen + y * ptBoard->iWords;
+  int       iLast  = ptBoard->iWords - 1;
+
+  // East with carry into the next word, then west with carry back.
+  for (int w = 0; w <= iLast; ++w) {
+    if (w > 0) pui64S[w] |= pui64S[w - 1] >> 63 & ~pui64E[w - 1] >> 63;
+    pui64S[w] = fillEast(pui64S[w], ~pui64E[w] << 1);
+  }
+  for (int w = iLast; w >= 0; --w) {
+    if (w < iLast) pui64S[w] |= (pui64S[w + 1] & 1) << 63 & ~pui64E[w];
+    pui64S[w] = fillWest(pui64S[w], ~pui64E[w]);
+  }
+  pui64S[iLast] &= ptBoard->ui64Last;
+}
+
+/*******************************************************************************
+ * Name:  boardReach
+ * Purpose: Reachability without distances. Whole corridors of a row are filled
+ *          at once, rows are swept down and up until nothing changes. Takes
+ *          maze coordinates, returns true if one cell reaches the other.
+ *******************************************************************************/
+int boardReach(t_board* ptBoard, int iFromX, int iFromY, int iToX, int iToY) {
+  int       iWords   = ptBoard->iWords;
+  int       iTo      = (iToY - 1) * iWords + ((iToX - 1) >> 6);
+  uint64_t  ui64To   = 1ULL << ((iToX - 1) & 63);
+  uint64_t* pui64S   = ptBoard->pui64Seen;
+  uint64_t* pui64W   = ptBoard->pui64South;
+  uint64_t  ui64New  = 0;
+  int       bChanged = 1;
+  int       bRow     = 0;
+
+  memset(pui64S, 0, (size_t) ptBoard->iH * iWords * sizeof(uint64_t));
+  pui64S[(iFromY - 1) * iWords + ((iFromX - 1) >> 6)] = 1ULL << ((iFromX - 1) & 63);
+  boardFillRow(ptBoard, iFromY - 1);
+
+  while (bChanged && ! (pui64S[iTo] & ui64To)) {
+    bChanged = 0;
+
+    // Down through open south walls of the row above ...
+    for (int y = 1; y < ptBoard->iH; ++y) {
+      bRow = 0;
+      for (int w = 0; w < iWords; ++w) {
+        ui64New = pui64S[(y - 1) * iWords + w] & ~pui64W[(y - 1) * iWords + w] & ~pui64S[y * iWords + w];
+        pui64S[y * iWords + w] |= ui64New;
+        bRow |= ui64New != 0;
+      }
+      if (bRow) boardFillRow(ptBoard, y);
+      bChanged |= bRow;
+    }
+
+    // ... and up through open south walls of the own row.
+    for (int y = ptBoard->iH - 2; y >= 0; --y) {
+      bRow = 0;
+      for (int w = 0; w < iWords; ++w) {
+        ui64New = pui64S[(y + 1) * iWords + w] & ~pui64W[y * iWords + w] & ~pui64S[y * iWords + w];
+        pui64S[y * iWords + w] |= ui64New;
+        bRow |= ui64New != 0;
+      }
+      if (bRow) boardFillRow(ptBoard, y);
+      bChanged |= bRow;
+    }
+  }
+
+  return (pui64S[iTo] & ui64To) != 0;
+}
+
+/*******************************************************************************
+ * Name:  radixFree
+ * Purpose: Frees all buckets of a radix heap.
+ *******************************************************************************/
+void radixFree(t_radix* ptRadix) {
+  for (int i = 0; i < RADIX_BUCKETS; ++i) {
+    free(ptRadix->apui64Key[i]);
+    free(ptRadix->apllVal[i]);
+  }
+  memset(ptRadix, 0, sizeof(t_radix));
+}
+
+/*******************************************************************************
+ * Name:  radixClear
+ * Purpose: Empties a radix heap, the buckets keep their memory.
+ *******************************************************************************/
+void radixClear(t_radix* ptRadix) {
+  memset(ptRadix->allSize, 0, sizeof(ptRadix->allSize));
+  ptRadix->ui64Last = 0;
+  ptRadix->llCount  = 0;
+}
+
+/*******************************************************************************
+ * Name:  radixAdd
+ * Purpose: Appends an entry to a bucket, doubles it when full. Returns false
+ *          if out of memory.
+ *******************************************************************************/
+int radixAdd(t_radix* ptRadix, int iBucket, uint64_t ui64Key, ll llVal) {
+  uint64_t* pui64Key = NULL;
+  ll*       pllVal   = NULL;
+  ll        llMax    = 0;
+
+  if (ptRadix->allSize[iBucket] == ptRadix->allMax[iBucket]) {
+    llMax    = ptRadix->allMax[iBucket] ? 2 * ptRadix->allMax[iBucket] : RADIX_FIRST;
+    pui64Key = (uint64_t*) realloc(ptRadix->apui64Key[iBucket], llMax * sizeof(uint64_t));
+    if (pui64Key == NULL) return 0;
+    ptRadix->apui64Key[iBucket] = pui64Key;
+    pllVal = (ll*) realloc(ptRadix->apllVal[iBucket], llMax * sizeof(ll));
+    if (pllVal == NULL) return 0;
+    ptRadix->apllVal[iBucket] = pllVal;
+    ptRadix->allMax[iBucket]  = llMax;
+  }
+
+  ptRadix->apui64Key[iBucket][ptRadix->allSize[iBucket]] = ui64Key;
+  ptRadix->apllVal[iBucket][ptRadix->allSize[iBucket]++] = llVal;
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  radixBucket
+ * Purpose: Returns the bucket of a key, the highest bit it differs from the
+ *          last popped key in.
+ *******************************************************************************/
+int radixBucket(t_radix* ptRadix, uint64_t ui64Key) {
+  return (ui64Key == ptRadix->ui64Last) ? 0 : 64 - __builtin_clzll(ui64Key ^ ptRadix->ui64Last);
+}
+
+/*******************************************************************************
+ * Name:  radixPush
+ * Purpose: Adds a key not below the last popped one. Returns false if out of
+ *          memory.
+ *******************************************************************************/
+int radixPush(t_radix* ptRadix, uint64_t ui64Key, ll llVal) {
+  ++ptRadix->llCount;
+  return radixAdd(ptRadix, radixBucket(ptRadix, ui64Key), ui64Key, llVal);
+}
+
+/*******************************************************************************
+ * Name:  radixPop
+ * Purpose: Takes an entry with the least key, the last added of equal ones.
+ *          The heap must not be empty. Returns false if out of memory.
+ *******************************************************************************/
+int radixPop(t_radix* ptRadix, uint64_t* pui64Key, ll* pllVal) {
+  uint64_t ui64Min = UINT64_MAX;
+  int      i       = 1;
+
+  // Spread the first filled bucket around its least key, which all of its
+  // keys differ from in lower bits only.
+  if (ptRadix->allSize[0] == 0) {
+    while (ptRadix->allSize[i] == 0) ++i;
+    for (ll j = 0; j < ptRadix->allSize[i]; ++j)
+      if (ptRadix->apui64Key[i][j] < ui64Min) ui64Min = ptRadix->apui64Key[i][j];
+    ptRadix->ui64Last = ui64Min;
+    for (ll j = 0; j < ptRadix->allSize[i]; ++j)
+      if (! radixAdd(ptRadix, radixBucket(ptRadix, ptRadix->apui64Key[i][j]),
+                     ptRadix->apui64Key[i][j], ptRadix->apllVal[i][j]))
+        return 0;
+    ptRadix->allSize[i] = 0;
+  }
+
+  --ptRadix->llCount;
+  *pui64Key = ptRadix->apui64Key[0][--ptRadix->allSize[0]];
+  *pllVal   = ptRadix->apllVal[0][ptRadix->allSize[0]];
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  pathFree
+ * Purpose: Frees the way and the solver's scratch.
+ *******************************************************************************/
+void pathFree(t_path* ptPath) {
+  free(ptPath->pcDirs);
+  for (int i = 0; i < 2; ++i) {
+    free(ptPath->apui64Seen[i]);
+    free(ptPath->apui8From[i]);
+    free(ptPath->apllQueue[i]);
+  }
+  radixFree(&ptPath->tOpen);
+  boardFree(&ptPath->tFill);
+  memset(ptPath, 0, sizeof(t_path));
+}
+
+/*******************************************************************************
+ * Name:  pathInit
+ * Purpose: Allocates the solver's scratch for the maze's grid and searches
+ *          from iSides ends, if it isn't already. Returns false if out of
+ *          memory.
+ *******************************************************************************/
+int pathInit(t_path* ptPath, t_maze* ptMaze, int iSides) {
+  if (ptPath->llGridCount != ptMaze->llGridCount) {
+    pathFree(ptPath);
+    ptPath->llGridCount = ptMaze->llGridCount;
+  }
+
+  for (int i = 0; i < iSides; ++i) {
+    if (ptPath->apllQueue[i] != NULL) continue;
+    // Seen bits start cleared, afterwards each solve clears what it set.
+    ptPath->allQueueSize[i] = SOLVE_QUEUE;
+    ptPath->allSeenLo[i]    = 0;
+    ptPath->allSeenHi[i]    = -1;
+    ptPath->apui64Seen[i]   = (uint64_t*) calloc((ptMaze->llGridCount >> 6) + 1, sizeof(uint64_t));
+    ptPath->apui8From[i]    = (uint8_t*)  malloc((ptMaze->llGridCount >> 2) + 1);
+    ptPath->apllQueue[i]    = (ll*)       malloc(ptPath->allQueueSize[i] * sizeof(ll));
+
+    if (ptPath->apui64Seen[i] == NULL || ptPath->apui8From[i] == NULL || ptPath->apllQueue[i] == NULL) {
+      pathFree(ptPath);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  pathClear
+ * Purpose: Clears the seen bits of the last solve, only the words between the
+ *          lowest and the highest one set. A search around a few cells of a
+ *          huge maze costs a few rows, not the grid.
+ *******************************************************************************/
+void pathClear(t_path* ptPath, int iSides) {
+  for (int i = 0; i < iSides; ++i) {
+    if (ptPath->allSeenHi[i] >= ptPath->allSeenLo[i])
+      memset(ptPath->apui64Seen[i] + ptPath->allSeenLo[i], 0,
+             (ptPath->allSeenHi[i] - ptPath->allSeenLo[i] + 1) * sizeof(uint64_t));
+    ptPath->allSeenLo[i] = LLONG_MAX;
+    ptPath->allSeenHi[i] = -1;
+  }
+}
+
+/*******************************************************************************
+ * Name:  isSeen
+ * Purpose: Returns true if a search from one end has reached a cell.
+ *******************************************************************************/
+int isSeen(t_path* ptPath, int iSide, ll llCell) {
+  return (ptPath->apui64Seen[iSide][llCell >> 6] >> (llCell & 63)) & 1;
+}
+
+/*******************************************************************************
+ * Name:  markSeen
+ * Purpose: Marks a cell as reached by the search from one end.
+ *******************************************************************************/
+void markSeen(t_path* ptPath, int iSide, ll llCell) {
+  ll llWord = llCell >> 6;
+  ptPath->apui64Seen[iSide][llWord] |= 1ULL << (llCell & 63);
+  if (llWord < ptPath->allSeenLo[iSide]) ptPath->allSeenLo[iSide] = llWord;
+  if (llWord > ptPath->allSeenHi[iSide]) ptPath->allSeenHi[iSide] = llWord;
+}
+
+/*******************************************************************************
+ * Name:  growQueue
+ * Purpose: Doubles a frontier ring when it is full, the cells keep their
+ *          order from llHead on. Returns false if out of memory.
+ *******************************************************************************/
+int growQueue(t_path* ptPath, int iSide, ll* pllHead, ll* pllTail) {
+  ll  llSize   = ptPath->allQueueSize[iSide];
+  ll* pllQueue = (ll*) malloc(2 * llSize * sizeof(ll));
+  ll  llFirst  = llSize - *pllHead;  // Cells from llHead to the ring's end.
+
+  if (pllQueue == NULL) return 0;
+
+  memcpy(pllQueue, ptPath->apllQueue[iSide] + *pllHead, llFirst * sizeof(ll));
+  memcpy(pllQueue + llFirst, ptPath->apllQueue[iSide], *pllHead * sizeof(ll));
+  free(ptPath->apllQueue[iSide]);
+
+  ptPath->apllQueue[iSide]    = pllQueue;
+  ptPath->allQueueSize[iSide] = 2 * llSize;
+  *pllHead                    = 0;
+  *pllTail                    = llSize;
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  solveStart
+ * Purpose: Prepares a solve from iSides ends. The only opening in the border
+ *          is the exit, it is shut for the search. Returns false if out of
+ *          memory.
+ *******************************************************************************/
+int solveStart(t_maze* ptMaze, t_path* ptPath, int iSides) {
+  ptPath->llLength   = -1;
+  ptPath->llExpanded = 0;
+  if (! pathInit(ptPath, ptMaze, iSides)) return 0;
+  pathClear(ptPath, iSides);
+
+  for (int i = 0; i < iSides; ++i)
+    markSeen(ptPath, i, getCellInDir(ptMaze, ptMaze->iExitDir, ptMaze->llExit));
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  pathTrace
+ * Purpose: Writes the way into ptPath, from llFrom up to llMeet as found from
+ *          the start and from llMeet on to llTo as found from the end. Returns
+ *          the steps or -2 if out of memory.
+ *******************************************************************************/
+ll pathTrace(t_maze* ptMaze, t_path* ptPath, ll llFrom, ll llMeet, ll llTo) {
+  ll  llFirst = 0;  // Steps from llFrom to llMeet.
+  ll  llSteps = 0;
+  ll  llStep  = 0;
+  ll  llCell  = 0;
+  int iDir    = 0;
+
+  // Count the steps back to both ends first.
+  for (llCell = llMeet; llCell != llFrom; ++llFirst)
+    llCell = getCellInDir(ptMaze, turnBack(getWalkDir(ptPath->apui8From[0], llCell)), llCell);
+  for (llCell = llMeet, llSteps = llFirst; llCell != llTo; ++llSteps)
+    llCell = getCellInDir(ptMaze, turnBack(getWalkDir(ptPath->apui8From[1], llCell)), llCell);
+
+  if (ptPath->llDirsSize < llSteps + 1) {
+    free(ptPath->pcDirs);
+    ptPath->llDirsSize = llSteps + 1;
+    if ((ptPath->pcDirs = (char*) malloc(ptPath->llDirsSize)) == NULL) {
+      ptPath->llDirsSize = 0;
+      return -2;
+    }
+  }
+  ptPath->pcDirs[llSteps] = '\0';
+
+  // Back to front up to llMeet ...
+  for (llCell = llMeet, llStep = llFirst - 1; llCell != llFrom; --llStep) {
+    iDir = getWalkDir(ptPath->apui8From[0], llCell);
+    ptPath->pcDirs[llStep] = g_dChar[iDir];
+    llCell = getCellInDir(ptMaze, turnBack(iDir), llCell);
+  }
+  // ... then on, the end's search entered each cell the other way round.
+  for (llCell = llMeet, llStep = llFirst; llCell != llTo; ++llStep) {
+    iDir = turnBack(getWalkDir(ptPath->apui8From[1], llCell));
+    ptPath->pcDirs[llStep] = g_dChar[iDir];
+    llCell = getCellInDir(ptMaze, iDir, llCell);
+  }
+
+  ptPath->llLength = llSteps;
+  return llSteps;
+}
+
+/*******************************************************************************
+ * Name:  solveBfs
+ * Purpose: Breadth first search from llFrom to llTo, the way ends up in
+ *          ptPath as directions. Nothing is allocated per step, the frontier
+ *          only grows by doubling. Returns the steps, -1 if there is no way
+ *          or -2 if out of memory.
+ *******************************************************************************/
+ll solveBfs(t_maze* ptMaze, ll llFrom, ll llTo, t_path* ptPath) {
+  ll* pllQueue = NULL;
+  ll  llMask   = 0;
+  ll  llHead   = 0;
+  ll  llTail   = 0;
+  ll  llCell   = llFrom;
+  ll  llNext   = 0;
+  int iOpen    = 0;
+  int iDir     = 0;
+
+  if (! solveStart(ptMaze, ptPath, 1)) return -2;
+
+  markSeen(ptPath, 0, llFrom);
+  pllQueue         = ptPath->apllQueue[0];
+  llMask           = ptPath->allQueueSize[0] - 1;
+  pllQueue[llTail++] = llFrom;
+
+  while (llHead != llTail) {
+    llCell = pllQueue[llHead];
+    llHead = (llHead + 1) & llMask;
+    ++ptPath->llExpanded;
+    if (llCell == llTo) break;
+
+    // Open sides only, one wall lookup for all four of them.
+    iOpen = ~getCellWalls(ptMaze, llCell) & CELL_WHOLE;
+    for (iDir = 0; iOpen != 0; ++iDir, iOpen >>= 1) {
+      if (! (iOpen & 1)) continue;
+      llNext = getCellInDir(ptMaze, iDir, llCell);
+      if (isSeen(ptPath, 0, llNext)) continue;
+      markSeen(ptPath, 0, llNext);
+      setWalkDir(ptPath->apui8From[0], llNext, iDir);
+
+      pllQueue[llTail] = llNext;
+      llTail = (llTail + 1) & llMask;
+      if (llTail == llHead) {
+        if (! growQueue(ptPath, 0, &llHead, &llTail)) return -2;
+        pllQueue = ptPath->apllQueue[0];
+        llMask   = ptPath->allQueueSize[0] - 1;
+      }
+    }
+  }
+  if (llCell != llTo) return -1;
+
+  return pathTrace(ptMaze, ptPath, llFrom, llTo, llTo);
+}
+
+/*******************************************************************************
+ * Name:  solveAStar
+ * Purpose: A* search from llFrom to llTo, ordered by steps taken plus the
+ *          Manhattan distance left. The open list is a radix heap, which keeps
+ *          its buckets between solves. Entries hold cell and direction it was
+ *          entered from, the steps taken follow from key and distance left.
+ *          Returns like solveBfs().
+ *******************************************************************************/
+ll solveAStar(t_maze* ptMaze, ll llFrom, ll llTo, t_path* ptPath) {
+  t_radix* ptOpen  = &ptPath->tOpen;
+  uint64_t ui64Key = 0;
+  ll       llVal   = 0;
+  ll       llCell  = 0;
+  ll       llNext  = 0;
+  ll       llSteps = 0;
+  int      iToX    = 0;
+  int      iToY    = 0;
+  int      iX      = 0;
+  int      iY      = 0;
+  int      iOpen   = 0;
+  int      iDir    = 0;
+
+  if (! solveStart(ptMaze, ptPath, 1)) return -2;
+
+  cell2xy(ptMaze, llTo, &iToX, &iToY);
+  cell2xy(ptMaze, llFrom, &iX, &iY);
+  radixClear(ptOpen);
+  if (! radixPush(ptOpen, abs(iX - iToX) + abs(iY - iToY), llFrom << 2)) return -2;
+
+  while (ptOpen->llCount != 0) {
+    if (! radixPop(ptOpen, &ui64Key, &llVal)) return -2;
+    llCell = llVal >> 2;
+    if (isSeen(ptPath, 0, llCell)) continue;
+
+    // First time taken is the shortest way there, the heuristic is consistent.
+    markSeen(ptPath, 0, llCell);
+    setWalkDir(ptPath->apui8From[0], llCell, llVal & 3);
+    ++ptPath->llExpanded;
+    if (llCell == llTo) break;
+
+    cell2xy(ptMaze, llCell, &iX, &iY);
+    llSteps = (ll) ui64Key - abs(iX - iToX) - abs(iY - iToY) + 1;
+
+    iOpen = ~getCellWalls(ptMaze, llCell) & CELL_WHOLE;
+    for (iDir = 0; iOpen != 0; ++iDir, iOpen >>= 1) {
+      if (! (iOpen & 1)) continue;
+      llNext = getCellInDir(ptMaze, iDir, llCell);
+      if (isSeen(ptPath, 0, llNext)) continue;
+      ui64Key = llSteps + abs(iX + (iDir == DIR_EAST) - (iDir == DIR_WEST) - iToX)
+                        + abs(iY + (iDir == DIR_SOUTH) - (iDir == DIR_NORTH) - iToY);
+      if (! radixPush(ptOpen, ui64Key, llNext << 2 | iDir)) return -2;
+    }
+  }
+  if (llCell != llTo) return -1;
+
+  return pathTrace(ptMaze, ptPath, llFrom, llTo, llTo);
+}
+
+/*******************************************************************************
+ * Name:  solveBidir
+ * Purpose: Breadth first search from both ends, a whole layer at a time of
+ *          the smaller frontier, until they meet. Returns like solveBfs().
+ *******************************************************************************/
+ll solveBidir(t_maze* ptMaze, ll llFrom, ll llTo, t_path* ptPath) {
+  ll  allHead[2] = {0};
+  ll  allTail[2] = {0};
+  ll  llLayer    = 0;
+  ll  llCell     = 0;
+  ll  llNext     = 0;
+  ll  llMeet     = -1;
+  int iSide      = 0;
+  int iOpen      = 0;
+  int iDir       = 0;
+
+  if (! solveStart(ptMaze, ptPath, 2)) return -2;
+  if (llFrom == llTo) return pathTrace(ptMaze, ptPath, llFrom, llTo, llTo);
+
+  markSeen(ptPath, 0, llFrom);
+  markSeen(ptPath, 1, llTo);
+  ptPath->apllQueue[0][allTail[0]++] = llFrom;
+  ptPath->apllQueue[1][allTail[1]++] = llTo;
+
+  while (llMeet == -1 && allHead[0] != allTail[0] && allHead[1] != allTail[1]) {
+    // Go on from the end with less cells in its frontier.
+    iSide = ((allTail[0] - allHead[0]) & (ptPath->allQueueSize[0] - 1)) >
+            ((allTail[1] - allHead[1]) & (ptPath->allQueueSize[1] - 1));
+
+    // The first meeting is a shortest way, the other end's frontier is one
+    // layer and all cells before it were looked at already.
+    for (llLayer = allTail[iSide]; allHead[iSide] != llLayer && llMeet == -1; ) {
+      llCell = ptPath->apllQueue[iSide][allHead[iSide]];
+      allHead[iSide] = (allHead[iSide] + 1) & (ptPath->allQueueSize[iSide] - 1);
+      ++ptPath->llExpanded;
+
+      iOpen = ~getCellWalls(ptMaze, llCell) & CELL_WHOLE;
+      for (iDir = 0; iOpen != 0; ++iDir, iOpen >>= 1) {
+        if (! (iOpen & 1)) continue;
+        llNext = getCellInDir(ptMaze, iDir, llCell);
+        if (isSeen(ptPath, iSide, llNext)) continue;
+        markSeen(ptPath, iSide, llNext);
+        setWalkDir(ptPath->apui8From[iSide], llNext, iDir);
+        if (isSeen(ptPath, ! iSide, llNext)) {
+          llMeet = llNext;
+          break;
+        }
+
+        ptPath->apllQueue[iSide][allTail[iSide]] = llNext;
+        allTail[iSide] = (allTail[iSide] + 1) & (ptPath->allQueueSize[iSide] - 1);
+        if (allTail[iSide] == allHead[iSide]) {
+          // The layer's end moves along with the cells, 0 if it is done.
+          llLayer = (llLayer - allHead[iSide]) & (ptPath->allQueueSize[iSide] - 1);
+          if (! growQueue(ptPath, iSide, &allHead[iSide], &allTail[iSide])) return -2;
+        }
+      }
+    }
+  }
+  if (llMeet == -1) return -1;
+
+  return pathTrace(ptMaze, ptPath, llFrom, llMeet, llTo);
+}
+
+/*******************************************************************************
+ * Name:  getLiveDirs
+ * Purpose: Returns the open sides of a bitboard cell to cells not filled as
+ *          CELL_* bits. Takes coordinates from 0.
+ *******************************************************************************/
+int getLiveDirs(t_board* ptBoard, int iX, int iY) {
+  ll        llWord = (ll) iY * ptBoard->iWords + (iX >> 6);
+  int       iBit   = iX & 63;
+  uint64_t* pui64F = ptBoard->pui64Seen;
+  int       iLive  = 0;
+  ll        llW    = 0;
+
+  if (iX < ptBoard->iW - 1 && ! ((ptBoard->pui64East[llWord] >> iBit) & 1)) {
+    llW = (ll) iY * ptBoard->iWords + ((iX + 1) >> 6);
+    if (! ((__atomic_load_n(&pui64F[llW], __ATOMIC_RELAXED) >> ((iX + 1) & 63)) & 1)) iLive |= CELL_EAST;
+  }
+  if (iX > 0) {
+    llW = (ll) iY * ptBoard->iWords + ((iX - 1) >> 6);
+    if (! ((ptBoard->pui64East[llW] >> ((iX - 1) & 63)) & 1) &&
+        ! ((__atomic_load_n(&pui64F[llW], __ATOMIC_RELAXED) >> ((iX - 1) & 63)) & 1)) iLive |= CELL_WEST;
+  }
+  if (iY > 0) {
+    llW = llWord - ptBoard->iWords;
+    if (! ((ptBoard->pui64South[llW] >> iBit) & 1) &&
+        ! ((__atomic_load_n(&pui64F[llW], __ATOMIC_RELAXED) >> iBit) & 1)) iLive |= CELL_NORTH;
+  }
+  if (iY < ptBoard->iH - 1 && ! ((ptBoard->pui64South[llWord] >> iBit) & 1)) {
+    llW = llWord + ptBoard->iWords;
+    if (! ((__atomic_load_n(&pui64F[llW], __ATOMIC_RELAXED) >> iBit) & 1)) iLive |= CELL_SOUTH;
+  }
+  return iLive;
+}
+
+/*******************************************************************************
+ * Name:  fillChase
+ * Purpose: Follows the corridor from a cell just filled and fills on, as long
+ *          as the next cell becomes a dead end. This saves a sweep per turn of
+ *          the corridor. Threads meeting at a junction may both leave it, the
+ *          next sweep gets it then.
+ *******************************************************************************/
+void fillChase(t_fill* ptFill, int iX, int iY) {
+  t_board* ptBoard = ptFill->ptBoard;
+  ll       llWord  = 0;
+  uint64_t ui64Bit = 0;
+  int      iLive   = 0;
+  int      iDir    = 0;
+
+  while (__builtin_popcount(iLive = getLiveDirs(ptBoard, iX, iY)) == 1) {
+    iDir = __builtin_ctz(iLive);
+    iX  += (iDir == DIR_EAST) - (iDir == DIR_WEST);
+    iY  += (iDir == DIR_SOUTH) - (iDir == DIR_NORTH);
+
+    llWord  = (ll) iY * ptBoard->iWords + (iX >> 6);
+    ui64Bit = 1ULL << (iX & 63);
+    if ((llWord == ptFill->allKeep[0] && ui64Bit == ptFill->aui64Keep[0]) ||
+        (llWord == ptFill->allKeep[1] && ui64Bit == ptFill->aui64Keep[1]))
+      return;
+    if (__builtin_popcount(getLiveDirs(ptBoard, iX, iY)) > 1) return;
+    if (__atomic_fetch_or(&ptBoard->pui64Seen[llWord], ui64Bit, __ATOMIC_RELAXED) & ui64Bit) return;
+  }
+}
+
+/*******************************************************************************
+ * Name:  fillRow
+ * Purpose: Fills the dead ends of a row, a word of 64 cells at a time. A cell
+ *          is a dead end with at most one open side to a cell not filled.
+ *          Each new one is chased down its corridor. Filled cells of other
+ *          rows may change meanwhile, they are only ever set. Returns true if
+ *          any cell got filled.
+ *******************************************************************************/
+int fillRow(t_fill* ptFill, int y) {
+  t_board*  ptBoard = ptFill->ptBoard;
+  int       iWords  = ptBoard->iWords;
+  uint64_t* pui64E  = ptBoard->pui64East  + (ll) y * iWords;
+  uint64_t* pui64S  = ptBoard->pui64South + (ll) y * iWords;
+  uint64_t* pui64F  = ptBoard->pui64Seen  + (ll) y * iWords;
+  uint64_t  ui64F   = 0;  // Filled cells of this word ...
+  uint64_t  ui64FW  = 0;  // ... of the word before ...
+  uint64_t  ui64FE  = 0;  // ... and of the word after.
+  uint64_t  ui64E   = 0;
+  uint64_t  ui64W   = 0;
+  uint64_t  ui64N   = 0;
+  uint64_t  ui64S   = 0;
+  uint64_t  ui64New = 0;
+  uint64_t  ui64Any = 0;
+  ll        llWord  = (ll) y * iWords;
+
+  for (int w = 0; w < iWords; ++w, ++llWord) {
+    ui64F  = __atomic_load_n(&pui64F[w], __ATOMIC_RELAXED);
+    ui64FE = (w < iWords - 1) ? __atomic_load_n(&pui64F[w + 1], __ATOMIC_RELAXED) : ~0ULL;
+
+    // Open sides to cells not filled, carries cross the words.
+    ui64E = ~pui64E[w] & ~(ui64F >> 1 | ui64FE << 63);
+    ui64W = ~(pui64E[w] << 1 | ((w > 0) ? pui64E[w - 1] >> 63 : 1)) & ~(ui64F << 1 | ui64FW >> 63);
+    ui64N = (y > 0) ? ~pui64S[w - iWords] & ~__atomic_load_n(&pui64F[w - iWords], __ATOMIC_RELAXED) : 0;
+    ui64S = (y < ptBoard->iH - 1) ? ~pui64S[w] & ~__atomic_load_n(&pui64F[w + iWords], __ATOMIC_RELAXED) : 0;
+
+    // Not more than one of the four is set.
+    ui64New = ~((ui64E & ui64W) | (ui64N & ui64S) | ((ui64E | ui64W) & (ui64N | ui64S))) & ~ui64F;
+    if (w == iWords - 1)              ui64New &= ptBoard->ui64Last;
+    if (llWord == ptFill->allKeep[0]) ui64New &= ~ptFill->aui64Keep[0];
+    if (llWord == ptFill->allKeep[1]) ui64New &= ~ptFill->aui64Keep[1];
+
+    // Chased cells may land in this word too, so they are or'ed in.
+    if (ui64New != 0) __atomic_fetch_or(&pui64F[w], ui64New, __ATOMIC_RELAXED);
+    ui64FW   = ui64F | ui64New;
+    ui64Any |= ui64New;
+    for (uint64_t ui64 = ui64New; ui64 != 0; ui64 &= ui64 - 1)
+      fillChase(ptFill, (w << 6) + __builtin_ctzll(ui64), y);
+  }
+
+  return ui64Any != 0;
+}
+
+/*******************************************************************************
+ * Name:  fillWorker
+ * Purpose: Thread filling bands of rows, down and up until nothing changes.
+ *******************************************************************************/
+void* fillWorker(void* pvFill) {
+  t_fill* ptFill   = (t_fill*) pvFill;
+  int     iH       = ptFill->ptBoard->iH;
+  int     iBand    = 0;
+  int     iFrom    = 0;
+  int     iTo      = 0;
+  int     bChanged = 0;
+  int     bAny     = 0;
+
+  while ((iBand = __atomic_fetch_add(&ptFill->iNext, 1, __ATOMIC_RELAXED)) < ptFill->iBands) {
+    iFrom = (int) ((ll) iH * iBand / ptFill->iBands);
+    iTo   = (int) ((ll) iH * (iBand + 1) / ptFill->iBands);
+    do {
+      bChanged = 0;
+      for (int y = iFrom; y < iTo; ++y)
+        bChanged |= fillRow(ptFill, y);
+      for (int y = iTo - 2; y >= iFrom; --y)
+        bChanged |= fillRow(ptFill, y);
+      bAny |= bChanged;
+    } while (bChanged);
+  }
+
+  if (bAny) __atomic_store_n(&ptFill->bChanged, 1, __ATOMIC_RELAXED);
+  return NULL;
+}
+
+/*******************************************************************************
+ * Name:  fillWayOn
+ * Purpose: Returns the only open side of a cell to a cell not filled, but
+ *          the way back, -1 if there is none or more than one.
+ *******************************************************************************/
+int fillWayOn(t_maze* ptMaze, t_board* ptBoard, ll llCell, int iX, int iY, int iBack) {
+  int iOpen = ~getCellWalls(ptMaze, llCell) & CELL_WHOLE;
+  int iNX   = 0;
+  int iNY   = 0;
+
+  if (iBack != -1)              iOpen &= ~getDirWall(iBack);
+  if (llCell == ptMaze->llExit) iOpen &= ~getDirWall(ptMaze->iExitDir);
+
+  for (int iDir = 0; iDir < DIR_MOD; ++iDir) {
+    if (! (iOpen & getDirWall(iDir))) continue;
+    iNX = iX - 1 + (iDir == DIR_EAST) - (iDir == DIR_WEST);
+    iNY = iY - 1 + (iDir == DIR_SOUTH) - (iDir == DIR_NORTH);
+    if ((ptBoard->pui64Seen[(ll) iNY * ptBoard->iWords + (iNX >> 6)] >> (iNX & 63)) & 1)
+      iOpen &= ~getDirWall(iDir);
+  }
+
+  return (__builtin_popcount(iOpen) == 1) ? __builtin_ctz(iOpen) : -1;
+}
+
+/*******************************************************************************
+ * Name:  solveDeadEnd
+ * Purpose: Fills all dead ends but the two ends on a bitboard, row bands on
+ *          the maze's threads. Rounds go on until no band changes, as bands
+ *          fill into each other. Left over in a perfect maze is the way, it
+ *          is walked from llFrom. Braided mazes keep their loops, their way
+ *          is searched breadth first. Returns like solveBfs(), the filled
+ *          cells stay in ptPath's tFill.pui64Seen.
+ *******************************************************************************/
+ll solveDeadEnd(t_maze* ptMaze, ll llFrom, ll llTo, t_path* ptPath) {
+  t_board* ptBoard = &ptPath->tFill;
+  t_fill   tFill   = {0};
+  ll       llCell  = 0;
+  ll       llSteps = 0;
+  int      iDir    = 0;
+  int      iX      = 0;
+  int      iY      = 0;
+
+  ptPath->llLength   = -1;
+  ptPath->llExpanded = 0;
+  if (ptBoard->iW != ptMaze->iMazeW || ptBoard->iH != ptMaze->iMazeH) {
+    boardFree(ptBoard);
+    if (! boardInit(ptBoard, ptMaze, GRID_MAX_LARGE)) return -2;
+  }
+  else
+    boardLoad(ptBoard, ptMaze);
+  memset(ptBoard->pui64Seen, 0, (size_t) ptBoard->iH * ptBoard->iWords * sizeof(uint64_t));
+
+  tFill.ptBoard = ptBoard;
+  tFill.iBands  = ptMaze->iThreads * FILL_BANDS;
+  if (tFill.iBands > ptBoard->iH) tFill.iBands = ptBoard->iH;
+  for (int i = 0; i < 2; ++i) {
+    cell2xy(ptMaze, (i == 0) ? llFrom : llTo, &iX, &iY);
+    tFill.allKeep[i]   = (ll) (iY - 1) * ptBoard->iWords + ((iX - 1) >> 6);
+    tFill.aui64Keep[i] = 1ULL << ((iX - 1) & 63);
+  }
+
+  do {
+    tFill.iNext    = 0;
+    tFill.bChanged = 0;
+    runThreads(ptMaze, fillWorker, &tFill);
+  } while (tFill.bChanged);
+
+  // Every cell is decided, filled or on the way.
+  ptPath->llExpanded = ptMaze->llMazeCount;
+
+  // Count the steps, then walk again writing them down.
+  for (int iPass = 0; iPass < 2; ++iPass) {
+    llCell  = llFrom;
+    llSteps = 0;
+    iDir    = -1;
+    cell2xy(ptMaze, llFrom, &iX, &iY);
+    while (llCell != llTo) {
+      // More than one way on, only in braided mazes.
+      if ((iDir = fillWayOn(ptMaze, ptBoard, llCell, iX, iY, (iDir == -1) ? -1 : turnBack(iDir))) == -1)
+        return solveBfs(ptMaze, llFrom, llTo, ptPath);
+      if (iPass == 1) ptPath->pcDirs[llSteps] = g_dChar[iDir];
+      goToCell(ptMaze, iDir, &llCell);
+      iX += (iDir == DIR_EAST) - (iDir == DIR_WEST);
+      iY += (iDir == DIR_SOUTH) - (iDir == DIR_NORTH);
+      ++llSteps;
+    }
+
+    if (iPass == 0 && ptPath->llDirsSize < llSteps + 1) {
+      free(ptPath->pcDirs);
+      ptPath->llDirsSize = llSteps + 1;
+      if ((ptPath->pcDirs = (char*) malloc(ptPath->llDirsSize)) == NULL) {
+        ptPath->llDirsSize = 0;
+        return -2;
+      }
+    }
+  }
+  ptPath->pcDirs[llSteps] = '\0';
+
+  ptPath->llLength = llSteps;
+  return llSteps;
+}
+
+/*******************************************************************************
+ * Name:  solvePath
+ * Purpose: Solves with one of the SOLVER_* searches, returns like solveBfs().
+ *******************************************************************************/
+ll solvePath(t_maze* ptMaze, int iSolver, ll llFrom, ll llTo, t_path* ptPath) {
+  if (iSolver == SOLVER_ASTAR) return solveAStar(ptMaze, llFrom, llTo, ptPath);
+  if (iSolver == SOLVER_BIDIR) return solveBidir(ptMaze, llFrom, llTo, ptPath);
+  if (iSolver == SOLVER_DEADEND) return solveDeadEnd(ptMaze, llFrom, llTo, ptPath);
+  return solveBfs(ptMaze, llFrom, llTo, ptPath);
+}
+
+/*******************************************************************************
+ * Name:  printSolution
+ * Purpose: Prints the way from llCell out through the exit to stdout and how
+ *          fast it was found to stderr.
+ *******************************************************************************/
+void printSolution(t_maze* ptMaze, int iSolver, ll llCell) {
+  t_path tPath  = {0};
+  double dStart = getSeconds();
+  double dTime  = 0.0;
+  ll     llRv   = solvePath(ptMaze, iSolver, llCell, ptMaze->llExit, &tPath);
+
+  dTime = getSeconds() - dStart;
+  if (llRv == -2) dispatchError(ERR_ELSE, "Not enough memory for solver");
+  if (llRv == -1) dispatchError(ERR_ELSE, "Maze has no way out");
+
+  // Last step leaves the maze through the exit.
+  printf("%s%c\n", tPath.pcDirs, g_dChar[ptMaze->iExitDir]);
+  fprintf(stderr, "Solved by %s, %lld steps, %lld cells expanded in %.3f s, %.0f cells/s\n",
+          g_acSolver[iSolver], tPath.llLength + 1, tPath.llExpanded, dTime, tPath.llExpanded / dTime);
+
+  pathFree(&tPath);
+}
+
+/*******************************************************************************
+ * Name:  treeFree
+ * Purpose: Frees a tree index.
+ *******************************************************************************/
+void treeFree(t_tree* ptTree) {
+  free(ptTree->pui32Pre);
+  free(ptTree->pui32Cell);
+  free(ptTree->pui32Depth);
+  free(ptTree->pui32Mask);
+  free(ptTree->pui32Table);
+  free(ptTree->pui8Up);
+  memset(ptTree, 0, sizeof(t_tree));
+}
+
+/*******************************************************************************
+ * Name:  treeRight
+ * Purpose: Returns the preorder number of the lesser depth, the right one if
+ *          both are equal. i has to be left of j.
+ *******************************************************************************/
+uint32_t treeRight(t_tree* ptTree, uint32_t i, uint32_t j) {
+  return (ptTree->pui32Depth[j] <= ptTree->pui32Depth[i]) ? j : i;
+}
+
+/*******************************************************************************
+ * Name:  treeBlockMin
+ * Purpose: Minimum depth between i and j within one block. The mask of j holds
+ *          all numbers of the block up to j with a greater depth after them,
+ *          the first one from i on is the rightmost minimum.
+ *******************************************************************************/
+uint32_t treeBlockMin(t_tree* ptTree, uint32_t i, uint32_t j) {
+  uint32_t ui32Mask = ptTree->pui32Mask[j] & (~0U << (i % TREE_BLOCK));
+  return (j - j % TREE_BLOCK) + __builtin_ctz(ui32Mask);
+}
+
+/*******************************************************************************
+ * Name:  treeMin
+ * Purpose: Returns the preorder number with the least depth between i and j,
+ *          the rightmost one of equal depths. Constant time.
+ *******************************************************************************/
+uint32_t treeMin(t_tree* ptTree, uint32_t i, uint32_t j) {
+  ll       llFrom = i / TREE_BLOCK;
+  ll       llTo   = j / TREE_BLOCK;
+  uint32_t ui32   = 0;
+  int      k      = 0;
+
+  if (llFrom == llTo) return treeBlockMin(ptTree, i, j);
+
+  ui32 = treeBlockMin(ptTree, i, llFrom * TREE_BLOCK + TREE_BLOCK - 1);
+  if (llTo - llFrom > 1) {
+    k    = 63 - __builtin_clzll(llTo - llFrom - 1);
+    ui32 = treeRight(ptTree, ui32, ptTree->pui32Table[k * ptTree->llBlocks + llFrom + 1]);
+    ui32 = treeRight(ptTree, ui32, ptTree->pui32Table[k * ptTree->llBlocks + llTo - (1LL << k)]);
+  }
+  return treeRight(ptTree, ui32, treeBlockMin(ptTree, llTo * TREE_BLOCK, j));
+}
+
+/*******************************************************************************
+ * Name:  treeInit
+ * Purpose: Builds the index of a perfect maze in linear time, rooted at the
+ *          exit. Returns false if out of memory, the grid is too large or the
+ *          maze is braided.
+ *******************************************************************************/
+int treeInit(t_tree* ptTree, t_maze* ptMaze) {
+  uint32_t* pui32Stack = NULL;
+  ll        llTop      = 0;
+  ll        llCell     = 0;
+  ll        llNext     = 0;
+  ll        llBlocks   = 0;
+  uint32_t  ui32Pre    = 0;
+  uint32_t  ui32Mask   = 0;
+  uint32_t* pui32T     = NULL;
+  int       iOpen      = 0;
+  int       iUp        = 0;
+
+  treeFree(ptTree);
+  if (ptMaze->llGridCount > TREE_MAX || ptMaze->iBraid != 0) return 0;
+
+  ptTree->llCount  = ptMaze->llMazeCount;
+  ptTree->llBlocks = llBlocks = (ptTree->llCount + TREE_BLOCK - 1) / TREE_BLOCK;
+  ptTree->iLevels  = 64 - __builtin_clzll(llBlocks);
+
+  ptTree->pui32Pre   = (uint32_t*) malloc(ptMaze->llGridCount * sizeof(uint32_t));
+  ptTree->pui32Cell  = (uint32_t*) malloc(llBlocks * TREE_BLOCK * sizeof(uint32_t));
+  ptTree->pui32Depth = (uint32_t*) malloc(llBlocks * TREE_BLOCK * sizeof(uint32_t));
+  ptTree->pui32Mask  = (uint32_t*) malloc(llBlocks * TREE_BLOCK * sizeof(uint32_t));
+  ptTree->pui32Table = (uint32_t*) malloc(ptTree->iLevels * llBlocks * sizeof(uint32_t));
+  ptTree->pui8Up     = (uint8_t*)  malloc((ptMaze->llGridCount >> 2) + 1);
+  pui32Stack         = (uint32_t*) malloc(ptTree->llCount * sizeof(uint32_t));
+
+  if (ptTree->pui32Pre == NULL || ptTree->pui32Cell == NULL || ptTree->pui32Depth == NULL ||
+      ptTree->pui32Mask == NULL || ptTree->pui32Table == NULL || ptTree->pui8Up == NULL ||
+      pui32Stack == NULL) {
+    free(pui32Stack);
+    treeFree(ptTree);
+    return 0;
+  }
+
+  // Depth first from the exit, every cell gets its number when taken from the
+  // stack. The exit's way out points to the border, which is never pushed.
+  setWalkDir(ptTree->pui8Up, ptMaze->llExit, ptMaze->iExitDir);
+  pui32Stack[llTop++] = (uint32_t) ptMaze->llExit;
+  while (llTop != STACK_EMPTY) {
+    llCell = pui32Stack[--llTop];
+    iUp    = getWalkDir(ptTree->pui8Up, llCell);
+
+    ptTree->pui32Pre[llCell]    = ui32Pre;
+    ptTree->pui32Cell[ui32Pre]  = (uint32_t) llCell;
+    ptTree->pui32Depth[ui32Pre] = (llCell == ptMaze->llExit) ? 0
+                                : ptTree->pui32Depth[ptTree->pui32Pre[getCellInDir(ptMaze, iUp, llCell)]] + 1;
+    ++ui32Pre;
+
+    iOpen = ~getCellWalls(ptMaze, llCell) & CELL_WHOLE & ~getDirWall(iUp);
+    for (int iDir = 0; iOpen != 0; ++iDir, iOpen >>= 1) {
+      if (! (iOpen & 1)) continue;
+      llNext = getCellInDir(ptMaze, iDir, llCell);
+      setWalkDir(ptTree->pui8Up, llNext, turnBack(iDir));
+      pui32Stack[llTop++] = (uint32_t) llNext;
+    }
+  }
+  free(pui32Stack);
+
+  // Pad the last block with the deepest depth, it is never the minimum.
+  for (ll i = ptTree->llCount; i < llBlocks * TREE_BLOCK; ++i)
+    ptTree->pui32Depth[i] = UINT32_MAX;
+
+  // Per block a stack of rising depths, as bit mask per number. Equal depths
+  // are dropped from the stack, so the rightmost minimum stays.
+  for (ll i = 0; i < llBlocks * TREE_BLOCK; ++i) {
+    if (i % TREE_BLOCK == 0) ui32Mask = 0;
+    while (ui32Mask != 0 &&
+           ptTree->pui32Depth[i - i % TREE_BLOCK + 31 - __builtin_clz(ui32Mask)] >= ptTree->pui32Depth[i])
+      ui32Mask &= ~(1U << (31 - __builtin_clz(ui32Mask)));
+    ui32Mask |= 1U << (i % TREE_BLOCK);
+    ptTree->pui32Mask[i] = ui32Mask;
+  }
+
+  // Sparse table over the blocks' minima, level k spans 2^k blocks.
+  pui32T = ptTree->pui32Table;
+  for (ll b = 0; b < llBlocks; ++b)
+    pui32T[b] = treeBlockMin(ptTree, b * TREE_BLOCK, b * TREE_BLOCK + TREE_BLOCK - 1);
+  for (int k = 1; k < ptTree->iLevels; ++k)
+    for (ll b = 0; b + (1LL << k) <= llBlocks; ++b)
+      pui32T[k * llBlocks + b] = treeRight(ptTree, pui32T[(k - 1) * llBlocks + b],
+                                           pui32T[(k - 1) * llBlocks + b + (1LL << (k - 1))]);
+
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  treeDistance
+ * Purpose: Returns the steps between two cells of the maze.
+ *******************************************************************************/
+ll treeDistance(t_tree* ptTree, ll llFrom, ll llTo) {
+  uint32_t ui32From = ptTree->pui32Pre[llFrom];
+  uint32_t ui32To   = ptTree->pui32Pre[llTo];
+  uint32_t ui32Top  = 0;
+
+  if (ui32From == ui32To) return 0;
+  if (ui32From > ui32To) {
+    ui32Top  = ui32From;
+    ui32From = ui32To;
+    ui32To   = ui32Top;
+  }
+
+  // The top of the way is the parent of the least deep cell after llFrom.
+  ui32Top = ptTree->pui32Depth[treeMin(ptTree, ui32From + 1, ui32To)] - 1;
+  return (ll) ptTree->pui32Depth[ui32From] + ptTree->pui32Depth[ui32To] - 2 * (ll) ui32Top;
+}
+
+/*******************************************************************************
+ * Name:  treeNextStep
+ * Purpose: Returns the direction of the first step from llFrom to llTo, -1 if
+ *          both are the same cell.
+ *******************************************************************************/
+int treeNextStep(t_tree* ptTree, ll llFrom, ll llTo) {
+  uint32_t ui32From = ptTree->pui32Pre[llFrom];
+  uint32_t ui32To   = ptTree->pui32Pre[llTo];
+  uint32_t ui32Min  = 0;
+
+  if (ui32From == ui32To) return -1;
+
+  // Only cells after llFrom can be below it, then go down to the child
+  // holding llTo, else up.
+  if (ui32From < ui32To) {
+    ui32Min = treeMin(ptTree, ui32From + 1, ui32To);
+    if (ptTree->pui32Depth[ui32Min] == ptTree->pui32Depth[ui32From] + 1)
+      return turnBack(getWalkDir(ptTree->pui8Up, ptTree->pui32Cell[ui32Min]));
+  }
+  return getWalkDir(ptTree->pui8Up, llFrom);
+}
+
+/*******************************************************************************
+ * Name:  graphFree
+ * Purpose: Frees a junction graph.
+ *******************************************************************************/
+void graphFree(t_graph* ptGraph) {
+  free(ptGraph->pui32Node);
+  free(ptGraph->pui32Cell);
+  free(ptGraph->pui32First);
+  free(ptGraph->pui32To);
+  free(ptGraph->pui32Len);
+  free(ptGraph->pllDirs);
+  free(ptGraph->pui8Dirs);
+  memset(ptGraph, 0, sizeof(t_graph));
+}
+
+/*******************************************************************************
+ * Name:  getOpenDirs
+ * Purpose: Returns the open sides of a cell as CELL_* bits, without the way
+ *          out through the exit.
+ *******************************************************************************/
+int getOpenDirs(t_maze* ptMaze, ll llCell) {
+  int iOpen = ~getCellWalls(ptMaze, llCell) & CELL_WHOLE;
+  if (llCell == ptMaze->llExit) iOpen &= ~getDirWall(ptMaze->iExitDir);
+  return iOpen;
+}
+
+/*******************************************************************************
+ * Name:  graphInit
+ * Purpose: Contracts the maze into its junction graph. All cells but the ones
+ *          with exactly two open sides become nodes, the exit always. Returns
+ *          false if out of memory or the grid is too large.
+ *******************************************************************************/
+int graphInit(t_graph* ptGraph, t_maze* ptMaze) {
+  ll       llCell  = 0;
+  ll       llNode  = 0;
+  ll       llEdge  = 0;
+  ll       llSteps = 0;  // Steps of all corridors, each open side starts one.
+  ll       llDirs  = 0;
+  uint32_t ui32Len = 0;
+  int      iOpen   = 0;
+  int      iDir    = 0;
+
+  graphFree(ptGraph);
+  if (ptMaze->llGridCount > GRAPH_MAX) return 0;
+
+  if ((ptGraph->pui32Node = (uint32_t*) malloc(ptMaze->llGridCount * sizeof(uint32_t))) == NULL)
+    return 0;
+
+  // Number the nodes row by row and count their edges.
+  for (int y = 1; y <= ptMaze->iMazeH; ++y) {
+    for (int x = 1; x <= ptMaze->iMazeW; ++x) {
+      llCell  = xy2cell(ptMaze, x, y);
+      iOpen   = __builtin_popcount(getOpenDirs(ptMaze, llCell));
+      llSteps += iOpen;
+      if (iOpen == 2 && llCell != ptMaze->llExit) {
+        ptGraph->pui32Node[llCell] = GRAPH_NONE;
+        continue;
+      }
+      ptGraph->pui32Node[llCell] = (uint32_t) ptGraph->llNodes++;
+      ptGraph->llEdges += iOpen;
+    }
+  }
 
-  // Get the right edge for the starting cell ...
-  if (iDir == DIR_NORTH) iY = g_tOpts.iMazeH;    // South border
-  if (iDir == DIR_WEST)  iX = g_tOpts.iMazeW;    // East  border
-  if (iDir == DIR_SOUTH) iY = 1;                 // North border
-  if (iDir == DIR_EAST)  iX = 1;                 // West  border
+  ptGraph->pui32Cell  = (uint32_t*) malloc(ptGraph->llNodes * sizeof(uint32_t));
+  ptGraph->pui32First = (uint32_t*) malloc((ptGraph->llNodes + 1) * sizeof(uint32_t));
+  ptGraph->pui32To    = (uint32_t*) malloc((ptGraph->llEdges + 1) * sizeof(uint32_t));
+  ptGraph->pui32Len   = (uint32_t*) malloc((ptGraph->llEdges + 1) * sizeof(uint32_t));
+  ptGraph->pllDirs    = (ll*)       malloc((ptGraph->llEdges + 1) * sizeof(ll));
+  ptGraph->pui8Dirs   = (uint8_t*)  malloc((llSteps >> 2) + 1);
 
-  // ... save cell for future use ;o) ...
-  iCell = xy2cell(iX, iY);
+  if (ptGraph->pui32Cell == NULL || ptGraph->pui32First == NULL || ptGraph->pui32To == NULL ||
+      ptGraph->pui32Len == NULL || ptGraph->pllDirs == NULL || ptGraph->pui8Dirs == NULL) {
+    graphFree(ptGraph);
+    return 0;
+  }
 
-  // ... and break the first wall in appropriate border for the exit.
-  if (iDir == DIR_NORTH) g_tMaze.piCells[iCell] /= CELL_SOUTH;
-  if (iDir == DIR_WEST)  g_tMaze.piCells[iCell] /= CELL_EAST;
-  if (iDir == DIR_SOUTH) g_tMaze.piCells[iCell] /= CELL_NORTH;
-  if (iDir == DIR_EAST)  g_tMaze.piCells[iCell] /= CELL_WEST;
+  // Walk every corridor from each of its ends to the node at the other end.
+  for (int y = 1; y <= ptMaze->iMazeH; ++y) {
+    for (int x = 1; x <= ptMaze->iMazeW; ++x) {
+      llNode = xy2cell(ptMaze, x, y);
+      if (ptGraph->pui32Node[llNode] == GRAPH_NONE) continue;
 
-  // Save first cell on stack.
-  pushCell(iCell);
+      ptGraph->pui32Cell[ptGraph->pui32Node[llNode]]  = (uint32_t) llNode;
+      ptGraph->pui32First[ptGraph->pui32Node[llNode]] = (uint32_t) llEdge;
 
-  // Walk through the maze and break walls until no cell is left to break into.
-  while (1) {
-    clearScreen();
-    printMaze(iDir, iCell);
-    usleep(80000);
-    iCellLast = iCell;
-    if (! goneToNextWholeCell(&iDir, &iCell)) break;
-    pushCell(iCell);
+      for (int iFirst = getOpenDirs(ptMaze, llNode); iFirst != 0; iFirst &= iFirst - 1) {
+        ptGraph->pllDirs[llEdge] = llDirs;
+        llCell  = llNode;
+        iDir    = __builtin_ctz(iFirst);
+        ui32Len = 0;
+        do {
+          setWalkDir(ptGraph->pui8Dirs, llDirs++, iDir);
+          goToCell(ptMaze, iDir, &llCell);
+          ++ui32Len;
+          // A corridor cell has one way on besides the way back.
+          if (ptGraph->pui32Node[llCell] == GRAPH_NONE)
+            iDir = __builtin_ctz(getOpenDirs(ptMaze, llCell) & ~getDirWall(turnBack(iDir)));
+        } while (ptGraph->pui32Node[llCell] == GRAPH_NONE);
+
+        ptGraph->pui32To[llEdge]  = ptGraph->pui32Node[llCell];
+        ptGraph->pui32Len[llEdge] = ui32Len;
+        ++llEdge;
+      }
+    }
   }
+  ptGraph->pui32First[ptGraph->llNodes] = (uint32_t) llEdge;
 
-  // Last cell will be the starting point.
-  *piCell = iCellLast;
+  return 1;
+}
 
-  return iDir;
+/*******************************************************************************
+ * Name:  getEdgeDir
+ * Purpose: Returns the direction of step i of an edge's corridor.
+ *******************************************************************************/
+int getEdgeDir(t_graph* ptGraph, ll llEdge, ll i) {
+  return getWalkDir(ptGraph->pui8Dirs, ptGraph->pllDirs[llEdge] + i);
+}
+
+/*******************************************************************************
+ * Name:  graphDistances
+ * Purpose: Steps from a node to all other nodes into pllDist, Dijkstra over
+ *          the edges with a radix heap, braided mazes have more than one way
+ *          to a node. Returns false if out of memory.
+ *******************************************************************************/
+int graphDistances(t_graph* ptGraph, uint32_t ui32From, ll* pllDist) {
+  t_radix  tOpen    = {0};
+  uint64_t ui64Key  = 0;
+  ll       llNode   = 0;
+  ll       llDist   = 0;
+  uint32_t ui32To   = 0;
+  int      bRv      = 1;
+
+  for (ll i = 0; i < ptGraph->llNodes; ++i) pllDist[i] = -1;
+  pllDist[ui32From] = 0;
+  bRv = radixPush(&tOpen, 0, ui32From);
+
+  while (bRv && tOpen.llCount != 0) {
+    if (! (bRv = radixPop(&tOpen, &ui64Key, &llNode))) break;
+    if ((ll) ui64Key != pllDist[llNode]) continue;  // Found shorter already.
+
+    for (uint32_t e = ptGraph->pui32First[llNode]; e < ptGraph->pui32First[llNode + 1] && bRv; ++e) {
+      ui32To = ptGraph->pui32To[e];
+      llDist = (ll) ui64Key + ptGraph->pui32Len[e];
+      if (pllDist[ui32To] != -1 && pllDist[ui32To] <= llDist) continue;
+      pllDist[ui32To] = llDist;
+      bRv = radixPush(&tOpen, llDist, ui32To);
+    }
+  }
+
+  radixFree(&tOpen);
+  return bRv;
+}
+
+/*******************************************************************************
+ * Name:  graphCellDistance
+ * Purpose: Steps from any cell to the node pllDist was computed from. A
+ *          corridor cell is walked to the nodes at both of its ends.
+ *******************************************************************************/
+ll graphCellDistance(t_graph* ptGraph, t_maze* ptMaze, ll* pllDist, ll llCell) {
+  ll  llBest  = -1;
+  ll  llNext  = 0;
+  ll  llSteps = 0;
+  int iDir    = 0;
+
+  if (ptGraph->pui32Node[llCell] != GRAPH_NONE) return pllDist[ptGraph->pui32Node[llCell]];
+
+  for (int iFirst = getOpenDirs(ptMaze, llCell); iFirst != 0; iFirst &= iFirst - 1) {
+    llNext  = llCell;
+    iDir    = __builtin_ctz(iFirst);
+    llSteps = 0;
+    do {
+      goToCell(ptMaze, iDir, &llNext);
+      ++llSteps;
+      if (ptGraph->pui32Node[llNext] == GRAPH_NONE)
+        iDir = __builtin_ctz(getOpenDirs(ptMaze, llNext) & ~getDirWall(turnBack(iDir)));
+    } while (ptGraph->pui32Node[llNext] == GRAPH_NONE);
+
+    llSteps += pllDist[ptGraph->pui32Node[llNext]];
+    if (llBest == -1 || llSteps < llBest) llBest = llSteps;
+  }
+  return llBest;
+}
+
+/*******************************************************************************
+ * Name:  printStats
+ * Purpose: Prints the maze's junctions, dead ends and corridors to stdout.
+ *******************************************************************************/
+void printStats(t_maze* ptMaze, ll llCell) {
+  t_graph tGraph      = {0};
+  ll*     pllDist     = NULL;
+  ll      allDegree[DIR_MOD + 1] = {0};
+  ll      llCorridors = 0;
+  ll      llSteps     = 0;
+  ll      llLongest   = 0;
+  ll      llFarthest  = 0;
+  ll      llDeadEnds  = 0;
+  double  dStart      = getSeconds();
+  double  dTime       = 0.0;
+  int     iDegree     = 0;
+
+  if (! graphInit(&tGraph, ptMaze))
+    dispatchError(ERR_ELSE, "Not enough memory for graph or maze too big");
+  dTime = getSeconds() - dStart;
+
+  if ((pllDist = (ll*) malloc(tGraph.llNodes * sizeof(ll))) == NULL ||
+      ! graphDistances(&tGraph, tGraph.pui32Node[ptMaze->llExit], pllDist))
+    dispatchError(ERR_ELSE, "Not enough memory for graph");
+
+  for (ll n = 0; n < tGraph.llNodes; ++n) {
+    iDegree = tGraph.pui32First[n + 1] - tGraph.pui32First[n];
+    ++allDegree[iDegree];
+    if (pllDist[n] > llFarthest) llFarthest = pllDist[n];
+    if (iDegree == 1) ++llDeadEnds;
+  }
+  for (ll e = 0; e < tGraph.llEdges; ++e) {
+    if (tGraph.pui32Len[e] > llLongest) llLongest = tGraph.pui32Len[e];
+    llSteps += tGraph.pui32Len[e];
+  }
+  llCorridors = tGraph.llEdges / 2;
+
+  printf("Cells              %lld\n", ptMaze->llMazeCount);
+  printf("Nodes              %lld (%.1f %% of cells)\n", tGraph.llNodes,
+         100.0 * tGraph.llNodes / ptMaze->llMazeCount);
+  printf("  dead ends        %lld\n", llDeadEnds);
+  printf("  junctions of 3   %lld\n", allDegree[3]);
+  printf("  junctions of 4   %lld\n", allDegree[4]);
+  printf("Corridors          %lld\n", llCorridors);
+  printf("  average length   %.2f\n", llCorridors ? (double) llSteps / tGraph.llEdges : 0.0);
+  printf("  longest          %lld\n", llLongest);
+  // Both count the last step out through the exit, like '--solve'.
+  printf("Start to exit      %lld\n", graphCellDistance(&tGraph, ptMaze, pllDist, llCell) + 1);
+  printf("Farthest from exit %lld\n", llFarthest + 1);
+  fprintf(stderr, "Graph built in %.3f s\n", dTime);
+
+  free(pllDist);
+  graphFree(&tGraph);
+}
+
+/*******************************************************************************
+ * Name:  distFree
+ * Purpose: Frees a distance field.
+ *******************************************************************************/
+void distFree(t_dist* ptDist) {
+  free(ptDist->pui16Dist);
+  free(ptDist->pui32Dist);
+  memset(ptDist, 0, sizeof(t_dist));
+}
+
+/*******************************************************************************
+ * Name:  distGet
+ * Purpose: Returns the steps from a cell to the exit, -1 if there is no way.
+ *******************************************************************************/
+ll distGet(t_dist* ptDist, ll llCell) {
+  uint32_t ui32 = (ptDist->iBits == 16) ? ptDist->pui16Dist[llCell] : ptDist->pui32Dist[llCell];
+  if (ptDist->iBits == 16 && ui32 == (uint16_t) DIST_NONE) return -1;
+  return (ui32 == DIST_NONE) ? -1 : ui32;
+}
+
+/*******************************************************************************
+ * Name:  distSet
+ * Purpose: Sets the steps from a cell to the exit.
+ *******************************************************************************/
+void distSet(t_dist* ptDist, ll llCell, ll llSteps) {
+  if (ptDist->iBits == 16)
+    ptDist->pui16Dist[llCell] = (uint16_t) llSteps;
+  else
+    ptDist->pui32Dist[llCell] = (uint32_t) llSteps;
+}
+
+/*******************************************************************************
+ * Name:  distWorker
+ * Purpose: Thread walking the corridors of chunks of edges, each cell gets
+ *          the steps over the nearer of both nodes. Each corridor is walked
+ *          once, from the node with the lower number or, for a loop back to
+ *          the same node, the lower of both sides it leaves by.
+ *******************************************************************************/
+void* distWorker(void* pvFill) {
+  t_distfill* ptFill  = (t_distfill*) pvFill;
+  t_graph*    ptGraph = ptFill->ptGraph;
+  t_maze*     ptMaze  = ptFill->ptMaze;
+  uint32_t    ui32    = 0;
+  uint32_t    ui32To  = 0;
+  ll          llFrom  = 0;
+  ll          llTo    = 0;
+  ll          llCell  = 0;
+  ll          llLen   = 0;
+  ll          llEnd   = 0;
+  ll          llNode  = 0;
+
+  while ((llFrom = __atomic_fetch_add(&ptFill->llNext, DIST_CHUNK, __ATOMIC_RELAXED)) < ptGraph->llEdges) {
+    llEnd = llFrom + DIST_CHUNK;
+    if (llEnd > ptGraph->llEdges) llEnd = ptGraph->llEdges;
+
+    // Edges are sorted by node, find the node of the chunk's first edge.
+    for (ui32 = 0, llNode = ptGraph->llNodes; ui32 < llNode; ) {
+      ll llMid = (ui32 + llNode) / 2;
+      if (ptGraph->pui32First[llMid + 1] <= llFrom) ui32 = (uint32_t) llMid + 1;
+      else llNode = llMid;
+    }
+
+    for (ll e = llFrom; e < llEnd; ++e) {
+      while (ptGraph->pui32First[ui32 + 1] <= e) ++ui32;
+      ui32To = ptGraph->pui32To[e];
+      llLen  = ptGraph->pui32Len[e];
+      if (ui32To < ui32) continue;
+      if (ui32To == ui32 && getEdgeDir(ptGraph, e, 0) > turnBack(getEdgeDir(ptGraph, e, llLen - 1)))
+        continue;
+
+      llFrom = ptFill->pllDist[ui32];
+      llTo   = ptFill->pllDist[ui32To];
+      llCell = ptGraph->pui32Cell[ui32];
+      for (ll i = 1; i < llLen; ++i) {
+        goToCell(ptMaze, getEdgeDir(ptGraph, e, i - 1), &llCell);
+        distSet(ptFill->ptDist, llCell, (llFrom + i < llTo + llLen - i) ? llFrom + i : llTo + llLen - i);
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/*******************************************************************************
+ * Name:  distInit
+ * Purpose: Builds the steps from each cell to the exit over the junction
+ *          graph, the corridors on the maze's threads. Returns false if out
+ *          of memory or the maze is too large. Mazes that would not fit
+ *          into free memory are refused up front, before the system has to
+ *          kill the process.
+ *******************************************************************************/
+int distInit(t_dist* ptDist, t_maze* ptMaze) {
+  t_graph    tGraph  = {0};
+  t_distfill tFill   = {0};
+  ll*        pllDist = NULL;
+  ll         llFree  = getFreeMemory();
+
+  distFree(ptDist);
+  if (llFree != -1 && ptMaze->llGridCount * DIST_BYTES > llFree) return 0;
+  if (! graphInit(&tGraph, ptMaze)) return 0;
+
+  // Ways are shorter than the cells in the maze.
+  ptDist->iBits = (ptMaze->llMazeCount < (uint16_t) DIST_NONE) ? 16 : 32;
+  if (ptDist->iBits == 16)
+    ptDist->pui16Dist = (uint16_t*) malloc(ptMaze->llGridCount * sizeof(uint16_t));
+  else
+    ptDist->pui32Dist = (uint32_t*) malloc(ptMaze->llGridCount * sizeof(uint32_t));
+  pllDist = (ll*) malloc(tGraph.llNodes * sizeof(ll));
+
+  if ((ptDist->pui16Dist == NULL && ptDist->pui32Dist == NULL) || pllDist == NULL ||
+      ! graphDistances(&tGraph, tGraph.pui32Node[ptMaze->llExit], pllDist)) {
+    free(pllDist);
+    graphFree(&tGraph);
+    distFree(ptDist);
+    return 0;
+  }
+
+  // All bits set is DIST_NONE, for the border.
+  memset((ptDist->iBits == 16) ? (void*) ptDist->pui16Dist : (void*) ptDist->pui32Dist, 0xff,
+         ptMaze->llGridCount * (ptDist->iBits / 8));
+  for (ll n = 0; n < tGraph.llNodes; ++n)
+    distSet(ptDist, tGraph.pui32Cell[n], pllDist[n]);
+
+  tFill.ptMaze  = ptMaze;
+  tFill.ptGraph = &tGraph;
+  tFill.ptDist  = ptDist;
+  tFill.pllDist = pllDist;
+  runThreads(ptMaze, distWorker, &tFill);
+
+  free(pllDist);
+  graphFree(&tGraph);
+  return 1;
+}
+
+/*******************************************************************************
+ * Name:  distBestDir
+ * Purpose: Returns the direction of a step nearer to the exit, out of the
+ *          maze at the exit, -1 if there is no way.
+ *******************************************************************************/
+int distBestDir(t_dist* ptDist, t_maze* ptMaze, ll llCell) {
+  ll  llSteps = distGet(ptDist, llCell);
+  int iOpen   = ~getCellWalls(ptMaze, llCell) & CELL_WHOLE;
+
+  if (llSteps <= 0) return (llSteps == 0) ? ptMaze->iExitDir : -1;
+  for (int iDir = 0; iDir < DIR_MOD; ++iDir)
+    if ((iOpen & getDirWall(iDir)) && distGet(ptDist, getCellInDir(ptMaze, iDir, llCell)) == llSteps - 1)
+      return iDir;
+  return -1;
+}
+
+/*******************************************************************************
+ * Name:  frameHint
+ * Purpose: Composes the steps to the exit and where to turn, seen from iDir.
+ *******************************************************************************/
+void frameHint(t_frame* ptFrame, t_dist* ptDist, t_maze* ptMaze, int iDir, ll llCell) {
+  const char* acTurn[MOVE_MOD] = {"ahead", "left", "back", "right"};
+  int         iBest            = -1;
+
+  // Mazes too big for a distance field are played without hints.
+  if (ptDist->iBits != 0) iBest = distBestDir(ptDist, ptMaze, llCell);
+
+  if (iBest == -1) {
+    frameAddf(ptFrame, "No hint available" FRAME_EOL "\n");
+    return;
+  }
+  // The last step out through the exit counts, like '--solve'.
+  frameAddf(ptFrame, "%lld steps to the exit, go %s" FRAME_EOL "\n", distGet(ptDist, llCell) + 1,
+            acTurn[(iBest - iDir + DIR_MOD) % DIR_MOD]);
+}
+
+/*******************************************************************************
+ * Name:  writeDist
+ * Purpose: Writes the distance field next to the maze's export as text
+ *          header 'maze dist <width> <height> <bits>' and the steps of the
+ *          maze's cells row by row in native byte order, border cells left
+ *          out. Cells without way hold all bits set.
+ *******************************************************************************/
+void writeDist(t_maze* ptMaze, const char* pcFile) {
+  t_dist tDist = {0};
+  cstr   csDist = csNew("");
+  FILE*  hFile  = NULL;
+  ll     llRow  = 0;
+
+  if (! distInit(&tDist, ptMaze))
+    dispatchError(ERR_ELSE, "Not enough memory for distances or maze too big");
+
+  csSetf(&csDist, "%s.dist", pcFile);
+  hFile = openFile(csDist.cStr, "wb");
+  fprintf(hFile, "maze dist %d %d %d\n", ptMaze->iMazeW, ptMaze->iMazeH, tDist.iBits);
+  for (int y = 1; y <= ptMaze->iMazeH; ++y) {
+    llRow = xy2cell(ptMaze, 1, y);
+    if (tDist.iBits == 16)
+      fwrite(tDist.pui16Dist + llRow, sizeof(uint16_t), ptMaze->iMazeW, hFile);
+    else
+      fwrite(tDist.pui32Dist + llRow, sizeof(uint32_t), ptMaze->iMazeW, hFile);
+  }
+  fclose(hFile);
+
+  csFree(&csDist);
+  distFree(&tDist);
+}
+
+/*******************************************************************************
+ * Name:  batchWorker
+ * Purpose: Thread generating mazes of a batch with its own maze context.
+ *******************************************************************************/
+void* batchWorker(void* pvBatch) {
+  t_batch* ptBatch = (t_batch*) pvBatch;
+  t_maze   tMaze   = {0};
+  ll       llCell  = 0;
+  int      iMaze   = 0;
+
+  if (! mazeInit(&tMaze, g_tOpts.iMazeW, g_tOpts.iMazeH, g_tOpts.bLarge, g_tOpts.llSeed)) {
+    __atomic_store_n(&ptBatch->bFailed, 1, __ATOMIC_RELAXED);
+    return NULL;
+  }
+
+  // The threads are used by the batch already.
+  tMaze.iAlgo   = g_tOpts.iAlgo;
+  tMaze.iPolicy = g_tOpts.iPolicy;
+  tMaze.iMix    = g_tOpts.iMix;
+  tMaze.iBraid  = g_tOpts.iBraid;
+
+  while ((iMaze = __atomic_fetch_add(&ptBatch->iNext, 1, __ATOMIC_RELAXED)) < g_tOpts.iCount) {
+    // Each maze gets its own seed, so it doesn't matter which thread builds it.
+    mazeReseed(&tMaze, g_tOpts.llSeed + iMaze);
+    if (generateMaze(&tMaze, &llCell, 0) == -1) {
+      __atomic_store_n(&ptBatch->bFailed, 1, __ATOMIC_RELAXED);
+      break;
+    }
+
+    if (ptBatch->hOut == NULL) continue;
+
+    // Wait for our turn to keep the mazes in order in the file.
+    pthread_mutex_lock(&ptBatch->tMutex);
+    while (ptBatch->iWritten != iMaze)
+      pthread_cond_wait(&ptBatch->tCond, &ptBatch->tMutex);
+    exportMaze(&tMaze, ptBatch->hOut);
+    fputc('\n', ptBatch->hOut);
+    ++ptBatch->iWritten;
+    pthread_cond_broadcast(&ptBatch->tCond);
+    pthread_mutex_unlock(&ptBatch->tMutex);
+  }
+
+  mazeFree(&tMaze);
+  return NULL;
+}
+
+/*******************************************************************************
+ * Name:  runBatch
+ * Purpose: Generates mazes on a pool of threads, exports them if wanted and
+ *          prints the speed. Like runThreads(), it goes on with the threads
+ *          that started, or alone if none did.
+ *******************************************************************************/
+void runBatch(FILE* hOut) {
+  pthread_t* ptThreads = (pthread_t*) malloc(g_tOpts.iThreads * sizeof(pthread_t));
+  t_batch    tBatch    = {0};
+  double     dStart    = getSeconds();
+  double     dTime     = 0.0;
+  ll         llCells   = (ll) g_tOpts.iMazeW * g_tOpts.iMazeH;
+  int        iStarted  = 0;
+
+  tBatch.hOut = hOut;
+  pthread_mutex_init(&tBatch.tMutex, NULL);
+  pthread_cond_init(&tBatch.tCond, NULL);
+
+  if (ptThreads != NULL)
+    while (iStarted < g_tOpts.iThreads &&
+           pthread_create(&ptThreads[iStarted], NULL, batchWorker, &tBatch) == 0)
+      ++iStarted;
+
+  if (iStarted == 0) batchWorker(&tBatch);
+  for (int i = 0; i < iStarted; ++i)
+    pthread_join(ptThreads[i], NULL);
+
+  dTime = getSeconds() - dStart;
+
+  pthread_cond_destroy(&tBatch.tCond);
+  pthread_mutex_destroy(&tBatch.tMutex);
+  free(ptThreads);
+
+  if (tBatch.bFailed)
+    dispatchError(ERR_ELSE, "Not enough memory for maze");
+
+  fprintf(stderr, "%d mazes %d x %d in %.3f s with %d threads: %.1f mazes/s, %.0f cells/s\n",
+          g_tOpts.iCount, g_tOpts.iMazeW, g_tOpts.iMazeH, dTime, (iStarted != 0) ? iStarted : 1,
+          g_tOpts.iCount / dTime, g_tOpts.iCount * llCells / dTime);
+}
+
+/*******************************************************************************
+ * Name:  printBenchResult
+ * Purpose: Prints one benchmark line with runs and items per second to stderr.
+ *******************************************************************************/
+void printBenchResult(const char* pcName, ll llRuns, ll llItems, double dTime) {
+  fprintf(stderr, "%-20s %12.1f runs/s %16.0f items/s\n",
+          pcName, (double) llRuns / dTime, (double) llItems / dTime);
+}
+
+/*******************************************************************************
+ * Name:  printStackStats
+ * Purpose: Prints the backtracker's deepest stack of the last maze to stderr.
+ *******************************************************************************/
+void printStackStats(t_maze* ptMaze) {
+  fprintf(stderr, "%-20s %12lld steps   %15.1f %% of cells, stack %.3f MB\n", "stack high water",
+          ptMaze->tStack.llMaxSize, 100.0 * ptMaze->tStack.llMaxSize / ptMaze->llMazeCount,
+          ((ptMaze->llMazeCount >> 2) + 1) / 1e6);
+}
+
+/*******************************************************************************
+ * Name:  benchFlood
+ * Purpose: Measures the per cell flood against the bitboard flood.
+ *******************************************************************************/
+void benchFlood(t_maze* ptMaze) {
+  t_board tBoard    = {0};
+  double  dStart    = 0.0;
+  double  dTime     = 0.0;
+  ll      llRuns    = 0;
+  ll      llReached = 0;
+  ll      llSteps   = 0;
+  ll      llCount   = 0;
+  int     iX        = 0;
+  int     iY        = 0;
+
+  if (! boardInit(&tBoard, ptMaze, BOARD_MAX_W)) {
+    fprintf(stderr, "Flood skipped, bitboards hold up to %d cells per row\n", BOARD_MAX_W);
+    return;
+  }
+
+  // Exit to the cell in the lower right corner, items are cells reached.
+  cell2xy(ptMaze, ptMaze->llExit, &iX, &iY);
+  llSteps = floodCells(ptMaze, ptMaze->llExit, xy2cell(ptMaze, ptMaze->iMazeW, ptMaze->iMazeH), &llCount);
+  fprintf(stderr, "Flood, %lld steps from exit to corner, items are cells reached\n", llSteps);
+
+  dStart = getSeconds();
+  do {
+    floodCells(ptMaze, ptMaze->llExit, xy2cell(ptMaze, ptMaze->iMazeW, ptMaze->iMazeH), &llReached);
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("flood per cell", llRuns, llRuns * llReached, dTime);
+
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    if (boardFlood(&tBoard, iX, iY, ptMaze->iMazeW, ptMaze->iMazeH, &llReached) != llSteps)
+      dispatchError(ERR_ELSE, "Bitboard flood differs");
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("flood bitboard", llRuns, llRuns * llReached, dTime);
+
+  // Only whether the corner is reached, no distances.
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    if (! boardReach(&tBoard, iX, iY, ptMaze->iMazeW, ptMaze->iMazeH))
+      dispatchError(ERR_ELSE, "Bitboard reach failed");
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("reach bitboard", llRuns, llRuns * llReached, dTime);
+
+  boardFree(&tBoard);
+}
+
+/*******************************************************************************
+ * Name:  benchSolve
+ * Purpose: Measures all solvers from llFrom to llTo, their scratch is kept
+ *          between the runs. Each way is walked once to check it.
+ *******************************************************************************/
+void benchSolve(t_maze* ptMaze, const char* pcName, ll llFrom, ll llTo) {
+  t_path tPath     = {0};
+  double dStart    = 0.0;
+  double dTime     = 0.0;
+  ll     llRuns    = 0;
+  ll     llItems   = 0;
+  ll     llReached = 0;
+  ll     llSteps   = 0;
+  ll     llCell    = 0;
+  int    iDir      = 0;
+  char   acName[32];
+
+  if ((llSteps = solveBfs(ptMaze, llFrom, llTo, &tPath)) < 0) {
+    fprintf(stderr, "Solve skipped, not enough memory\n");
+    pathFree(&tPath);
+    return;
+  }
+  if (! ptMaze->bLarge && floodCells(ptMaze, llFrom, llTo, &llReached) != llSteps)
+    dispatchError(ERR_ELSE, "Solver and flood differ");
+  fprintf(stderr, "Solve, %lld steps %s, items are cells expanded\n", llSteps, pcName);
+
+  for (int iSolver = 0; iSolver < SOLVER_COUNT; ++iSolver) {
+    if (solvePath(ptMaze, iSolver, llFrom, llTo, &tPath) != llSteps)
+      dispatchError(ERR_ELSE, "Solvers differ");
+    llCell = llFrom;
+    for (ll i = 0; i < llSteps; ++i) {
+      iDir = (int) (strchr(g_dChar, tPath.pcDirs[i]) - g_dChar);
+      if (isWallInDir(ptMaze, iDir, llCell)) dispatchError(ERR_ELSE, "Solver walks through walls");
+      goToCell(ptMaze, iDir, &llCell);
+    }
+    if (llCell != llTo) dispatchError(ERR_ELSE, "Solver misses the end");
+
+    llRuns  = 0;
+    llItems = 0;
+    dStart  = getSeconds();
+    do {
+      solvePath(ptMaze, iSolver, llFrom, llTo, &tPath);
+      llItems += tPath.llExpanded;
+      ++llRuns;
+    } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+    snprintf(acName, sizeof(acName), "solve %s", g_acSolver[iSolver]);
+    printBenchResult(acName, llRuns, llItems, dTime);
+    fprintf(stderr, "%-20s %12lld cells per solve\n", "", tPath.llExpanded);
+  }
+
+  pathFree(&tPath);
+}
+
+/*******************************************************************************
+ * Name:  benchTree
+ * Purpose: Measures building the tree index and queries between random cells,
+ *          some are checked against the solver and by walking next steps.
+ *******************************************************************************/
+void benchTree(t_maze* ptMaze) {
+  t_tree tTree   = {0};
+  t_path tPath   = {0};
+  t_rand tRand   = {0};
+  double dStart  = 0.0;
+  double dTime   = 0.0;
+  ll     llRuns  = 0;
+  ll     llSum   = 0;
+  ll     llFrom  = 0;
+  ll     llTo    = 0;
+  ll     llSteps = 0;
+  ll*    pllCell = NULL;
+
+  randSeed(&tRand, ptMaze->llSeed);
+  fprintf(stderr, "Tree index, items are cells for the build, else queries\n");
+
+  dStart = getSeconds();
+  do {
+    if (! treeInit(&tTree, ptMaze)) {
+      fprintf(stderr, "Tree skipped, not enough memory, more than %lld grid cells or braided\n", TREE_MAX);
+      return;
+    }
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("tree build", llRuns, llRuns * ptMaze->llMazeCount, dTime);
+
+  // Random cells drawn before, so only queries are measured.
+  if ((pllCell = (ll*) malloc(2048 * sizeof(ll))) == NULL) {
+    treeFree(&tTree);
+    return;
+  }
+  for (int i = 0; i < 2048; ++i)
+    pllCell[i] = xy2cell(ptMaze, randIab(&tRand, 1, ptMaze->iMazeW + 1),
+                                 randIab(&tRand, 1, ptMaze->iMazeH + 1));
+
+  for (int i = 0; i < 16; ++i) {
+    llFrom  = pllCell[2 * i];
+    llTo    = pllCell[2 * i + 1];
+    llSteps = 0;
+    if (solveBfs(ptMaze, llFrom, llTo, &tPath) != treeDistance(&tTree, llFrom, llTo))
+      dispatchError(ERR_ELSE, "Tree distance and solver differ");
+    for (int iDir = 0; (iDir = treeNextStep(&tTree, llFrom, llTo)) != -1; ++llSteps)
+      goToCell(ptMaze, iDir, &llFrom);
+    if (llSteps != tPath.llLength)
+      dispatchError(ERR_ELSE, "Tree steps and solver differ");
+  }
+  pathFree(&tPath);
+
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    for (int i = 0; i < 1024; ++i)
+      llSum += treeDistance(&tTree, pllCell[2 * i], pllCell[2 * i + 1]);
+    llRuns += 1024;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("tree distance", llRuns, llRuns, dTime);
+
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    for (int i = 0; i < 1024; ++i)
+      llSum += treeNextStep(&tTree, pllCell[2 * i], pllCell[2 * i + 1]);
+    llRuns += 1024;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("tree next step", llRuns, llRuns, dTime);
+
+  // Keep the compiler from dropping the loops.
+  if (llSum == 42) fprintf(stderr, "\n");
+
+  free(pllCell);
+  treeFree(&tTree);
+}
+
+/*******************************************************************************
+ * Name:  benchGraph
+ * Purpose: Measures contracting the maze and the distances of all nodes to
+ *          the exit against a flood through all cells. Random cells are
+ *          checked against the tree index.
+ *******************************************************************************/
+void benchGraph(t_maze* ptMaze) {
+  t_graph tGraph    = {0};
+  t_tree  tTree     = {0};
+  t_rand  tRand     = {0};
+  double  dStart    = 0.0;
+  double  dTime     = 0.0;
+  ll      llRuns    = 0;
+  ll      llReached = 0;
+  ll      llCell    = 0;
+  ll*     pllDist   = NULL;
+
+  dStart = getSeconds();
+  do {
+    if (! graphInit(&tGraph, ptMaze)) {
+      fprintf(stderr, "Graph skipped, not enough memory or more than %lld grid cells\n", GRAPH_MAX);
+      return;
+    }
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  fprintf(stderr, "Graph, %lld nodes, %.2f cells per node, items are cells\n",
+          tGraph.llNodes, (double) ptMaze->llMazeCount / tGraph.llNodes);
+  printBenchResult("graph build", llRuns, llRuns * ptMaze->llMazeCount, dTime);
+
+  if ((pllDist = (ll*) malloc(tGraph.llNodes * sizeof(ll))) == NULL) {
+    graphFree(&tGraph);
+    return;
+  }
+
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    if (! graphDistances(&tGraph, tGraph.pui32Node[ptMaze->llExit], pllDist))
+      dispatchError(ERR_ELSE, "Not enough memory for graph");
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("graph to exit", llRuns, llRuns * ptMaze->llMazeCount, dTime);
+
+  // All cells, the corner is just a cell to aim at. Needs a byte per cell.
+  if (! ptMaze->bLarge) {
+    llRuns = 0;
+    dStart = getSeconds();
+    do {
+      floodCells(ptMaze, ptMaze->llExit, -1, &llReached);
+      ++llRuns;
+    } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+    printBenchResult("flood to exit", llRuns, llRuns * ptMaze->llMazeCount, dTime);
+  }
+
+  if (treeInit(&tTree, ptMaze)) {
+    randSeed(&tRand, ptMaze->llSeed);
+    for (int i = 0; i < 1024; ++i) {
+      llCell = xy2cell(ptMaze, randIab(&tRand, 1, ptMaze->iMazeW + 1),
+                               randIab(&tRand, 1, ptMaze->iMazeH + 1));
+      if (graphCellDistance(&tGraph, ptMaze, pllDist, llCell) != treeDistance(&tTree, llCell, ptMaze->llExit))
+        dispatchError(ERR_ELSE, "Graph and tree distance differ");
+    }
+    treeFree(&tTree);
+  }
+
+  free(pllDist);
+  graphFree(&tGraph);
+}
+
+/*******************************************************************************
+ * Name:  benchDist
+ * Purpose: Measures building the distance field on 1 and on all threads and
+ *          hint lookups, random cells are checked against the solver.
+ *******************************************************************************/
+void benchDist(t_maze* ptMaze) {
+  t_dist tDist    = {0};
+  t_path tPath    = {0};
+  t_rand tRand    = {0};
+  double dStart   = 0.0;
+  double dTime    = 0.0;
+  ll     llRuns   = 0;
+  ll     llSum    = 0;
+  ll*    pllCell  = NULL;
+  int    iThreads = ptMaze->iThreads;
+  char   acName[32];
+
+  fprintf(stderr, "Distance field, items are cells for the build, else lookups\n");
+  for (int iT = 1; iT <= iThreads; iT = (iT == iThreads) ? iT + 1 : iThreads) {
+    ptMaze->iThreads = iT;
+    llRuns = 0;
+    dStart = getSeconds();
+    do {
+      if (! distInit(&tDist, ptMaze)) {
+        fprintf(stderr, "Distances skipped, not enough memory or more than %lld grid cells\n", GRAPH_MAX);
+        ptMaze->iThreads = iThreads;
+        return;
+      }
+      ++llRuns;
+    } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+    snprintf(acName, sizeof(acName), "dist %d bits %d thr", tDist.iBits, iT);
+    printBenchResult(acName, llRuns, llRuns * ptMaze->llMazeCount, dTime);
+  }
+  ptMaze->iThreads = iThreads;
+
+  if ((pllCell = (ll*) malloc(1024 * sizeof(ll))) == NULL) {
+    distFree(&tDist);
+    return;
+  }
+  randSeed(&tRand, ptMaze->llSeed);
+  for (int i = 0; i < 1024; ++i)
+    pllCell[i] = xy2cell(ptMaze, randIab(&tRand, 1, ptMaze->iMazeW + 1),
+                                 randIab(&tRand, 1, ptMaze->iMazeH + 1));
+
+  for (int i = 0; i < 16; ++i)
+    if (solveBfs(ptMaze, pllCell[i], ptMaze->llExit, &tPath) != distGet(&tDist, pllCell[i]))
+      dispatchError(ERR_ELSE, "Distance field and solver differ");
+  pathFree(&tPath);
+
+  // Best way on, as asked for on each key press.
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    for (int i = 0; i < 1024; ++i)
+      llSum += distBestDir(&tDist, ptMaze, pllCell[i]);
+    llRuns += 1024;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("dist best way", llRuns, llRuns, dTime);
+
+  // Keep the compiler from dropping the loops.
+  if (llSum == 42) fprintf(stderr, "\n");
+
+  free(pllCell);
+  distFree(&tDist);
+}
+
+/*******************************************************************************
+ * Name:  benchSight
+ * Purpose: Measures building the sight records and checks all of them against
+ *          walking the cells, then compares lookups to walks.
+ *******************************************************************************/
+void benchSight(t_maze* ptMaze) {
+  t_sight tSight  = {0};
+  t_sight tNone   = {0};
+  t_rand  tRand   = {0};
+  double  dStart  = 0.0;
+  double  dTime   = 0.0;
+  ll      llRuns  = 0;
+  ll      llSum   = 0;
+  ll*     pllCell = NULL;
+  int     aiGot[4];
+  int     aiWant[4];
+
+  fprintf(stderr, "Sight records, items are cells for the build, else looks\n");
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    if (! sightInit(&tSight, ptMaze)) {
+      fprintf(stderr, "Sight records skipped, not enough memory or more than %lld grid cells\n",
+              SIGHT_MAX);
+      return;
+    }
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("sight build", llRuns, llRuns * ptMaze->llMazeCount, dTime);
+
+  for (int y = 1; y < ptMaze->iMazeH + 1; ++y) {
+    for (int x = 1; x < ptMaze->iMazeW + 1; ++x) {
+      for (int iDir = 0; iDir < DIR_MOD; ++iDir) {
+        aiGot[0]  = sightWalk(&tSight, ptMaze, iDir, xy2cell(ptMaze, x, y), &aiGot[1], &aiGot[2], &aiGot[3]);
+        aiWant[0] = viewWalk(ptMaze, iDir, xy2cell(ptMaze, x, y), &aiWant[1], &aiWant[2], &aiWant[3]);
+        if (memcmp(aiGot, aiWant, sizeof(aiGot)))
+          dispatchError(ERR_ELSE, "Sight records and walks differ");
+      }
+    }
+  }
+
+  if ((pllCell = (ll*) malloc(1024 * sizeof(ll))) == NULL) {
+    sightFree(&tSight);
+    return;
+  }
+  randSeed(&tRand, ptMaze->llSeed);
+  for (int i = 0; i < 1024; ++i)
+    pllCell[i] = xy2cell(ptMaze, randIab(&tRand, 1, ptMaze->iMazeW + 1),
+                                 randIab(&tRand, 1, ptMaze->iMazeH + 1));
+
+  // One look per frame of the first person view, records against walks.
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    for (int i = 0; i < 1024; ++i)
+      llSum += sightWalk(&tSight, ptMaze, i & 3, pllCell[i], &aiGot[1], &aiGot[2], &aiGot[3]) + aiGot[1];
+    llRuns += 1024;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("sight record", llRuns, llRuns, dTime);
+
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    for (int i = 0; i < 1024; ++i)
+      llSum += sightWalk(&tNone, ptMaze, i & 3, pllCell[i], &aiGot[1], &aiGot[2], &aiGot[3]) + aiGot[1];
+    llRuns += 1024;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("sight walk", llRuns, llRuns, dTime);
+
+  // Keep the compiler from dropping the loops.
+  if (llSum == 42) fprintf(stderr, "\n");
+
+  free(pllCell);
+  sightFree(&tSight);
+}
+
+/*******************************************************************************
+ * Name:  runBenchmarks
+ * Purpose: Measures generation of all generators and growing tree policies,
+ *          full-maze render throughput and how the tile generator scales with
+ *          threads.
+ *******************************************************************************/
+void runBenchmarks(t_maze* ptMaze) {
+  double   dStart   = 0.0;
+  double   dTime    = 0.0;
+  double   dRate1   = 0.0;
+  ll       llRuns   = 0;
+  t_sight  tSight   = {0};
+  ll       llCell   = 0;
+  ll       llWalk   = 0;
+  ll       llBytes  = 0;
+  int      iDir     = 0;
+  int      iWalkDir = 0;
+  int      iAlgo    = 0;
+  int      iPolicy  = 0;
+  int      iMix     = 0;
+  int      iThreads = 0;
+  int      iCores   = 0;
+  uint64_t ui64     = 0;
+  char     acName[32];
+
+  fprintf(stderr, "Maze %d x %d, seed %lld, items are cells, grid uses %.3f MB\n",
+          ptMaze->iMazeW, ptMaze->iMazeH, ptMaze->llSeed,
+          (ptMaze->bLarge ? ptMaze->llGridCount / 4.0 : (double) ptMaze->llGridCount) / 1e6);
+
+  // Generation without any terminal output, every generator on '-t' threads.
+  iAlgo    = ptMaze->iAlgo;
+  iThreads = ptMaze->iThreads;
+  for (ptMaze->iAlgo = 0; ptMaze->iAlgo < ALGO_COUNT; ++ptMaze->iAlgo) {
+    if (ptMaze->iAlgo == ALGO_KRUSKAL && ptMaze->llMazeCount > KRUSKAL_MAX) continue;
+    llRuns = 0;
+    dStart = getSeconds();
+    do {
+      iDir = generateMaze(ptMaze, &llCell, 0);
+      ++llRuns;
+    } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+    snprintf(acName, sizeof(acName), "generate %s", g_acAlgo[ptMaze->iAlgo]);
+    printBenchResult(acName, llRuns, llRuns * ptMaze->llMazeCount, dTime);
+    if (ptMaze->iAlgo == ALGO_BACKTRACK) printStackStats(ptMaze);
+  }
+
+  // Growing tree, cost of each policy.
+  iPolicy       = ptMaze->iPolicy;
+  iMix          = ptMaze->iMix;
+  ptMaze->iAlgo = ALGO_GROWING;
+  ptMaze->iMix  = 50;
+  for (ptMaze->iPolicy = 0; ptMaze->iPolicy < POLICY_COUNT; ++ptMaze->iPolicy) {
+    llRuns = 0;
+    dStart = getSeconds();
+    do {
+      iDir = generateMaze(ptMaze, &llCell, 0);
+      ++llRuns;
+    } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+    snprintf(acName, sizeof(acName), "growing %s%s", g_acPolicy[ptMaze->iPolicy],
+             (ptMaze->iPolicy == POLICY_MIX) ? ":50" : "");
+    printBenchResult(acName, llRuns, llRuns * ptMaze->llMazeCount, dTime);
+  }
+  ptMaze->iPolicy = iPolicy;
+  ptMaze->iMix    = iMix;
+
+  // Tile generator scaling, doubling threads up to the number of cores.
+  iCores   = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (iCores < 1) iCores = 1;
+  ptMaze->iAlgo = ALGO_TILES;
+  fprintf(stderr, "Tile generator on %d cores, speedup against 1 thread\n", iCores);
+  for (int iT = 1; iT <= iCores; iT = (iT == iCores || iT * 2 <= iCores) ? iT * 2 : iCores) {
+    ptMaze->iThreads = iT;
+    llRuns = 0;
+    dStart = getSeconds();
+    do {
+      iDir = generateMaze(ptMaze, &llCell, 0);
+      ++llRuns;
+    } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+    if (iT == 1) dRate1 = llRuns / dTime;
+    snprintf(acName, sizeof(acName), "tiles %d threads", iT);
+    printBenchResult(acName, llRuns, llRuns * ptMaze->llMazeCount, dTime);
+    fprintf(stderr, "%-20s %12.2f x\n", "", llRuns / dTime / dRate1);
+  }
+  ptMaze->iAlgo    = iAlgo;
+  ptMaze->iThreads = iThreads;
+  iDir = generateMaze(ptMaze, &llCell, 0);
+
+  // Flood from the exit to the corner, cell by cell against the bitboard.
+  benchFlood(ptMaze);
+
+  // Solver from the start, and from the exit to the corner like the flood.
+  benchSolve(ptMaze, "from start to exit", llCell, ptMaze->llExit);
+  benchSolve(ptMaze, "from exit to corner", ptMaze->llExit, xy2cell(ptMaze, ptMaze->iMazeW, ptMaze->iMazeH));
+
+  // Tree index against the solver.
+  benchTree(ptMaze);
+
+  // Junction graph against cell by cell.
+  benchGraph(ptMaze);
+  benchDist(ptMaze);
+  benchSight(ptMaze);
+
+  // Solvers again with a tenth of the dead ends opened.
+  fprintf(stderr, "Braided 10 %%\n");
+  ptMaze->iBraid = 10;
+  iDir = generateMaze(ptMaze, &llCell, 0);
+  benchSolve(ptMaze, "from start to exit", llCell, ptMaze->llExit);
+  benchSolve(ptMaze, "from corner to corner", xy2cell(ptMaze, 1, 1),
+             xy2cell(ptMaze, ptMaze->iMazeW, ptMaze->iMazeH));
+  benchGraph(ptMaze);
+  benchDist(ptMaze);
+  benchSight(ptMaze);
+  ptMaze->iBraid = 0;
+  iDir = generateMaze(ptMaze, &llCell, 0);
+
+  // Whole frames of the grid in frames per second, also above GRID_MAX. Redirect
+  // stdout to '/dev/null' to measure pure rendering.
+  if (ptMaze->iMazeW <= FRAME_BENCH && ptMaze->iMazeH <= FRAME_BENCH) {
+    frameView(&ptMaze->tFrame, ptMaze, llCell, 4 * ptMaze->iMazeW + 1, 2 * ptMaze->iMazeH + 1 + FRAME_LINES);
+    llRuns = 0;
+    dStart = getSeconds();
+    do {
+      frameStart(&ptMaze->tFrame);
+      frameGrid(&ptMaze->tFrame, ptMaze, iDir, llCell);
+      frameFlush(&ptMaze->tFrame);
+      ++llRuns;
+    } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+    printBenchResult("render frames", llRuns, llRuns * ptMaze->llMazeCount, dTime);
+  }
+
+  // Whole frames of a view, costs the same for any maze.
+  frameView(&ptMaze->tFrame, ptMaze, llCell, FRAME_COLS, FRAME_ROWS);
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    frameStart(&ptMaze->tFrame);
+    frameGrid(&ptMaze->tFrame, ptMaze, iDir, llCell);
+    frameFlush(&ptMaze->tFrame);
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("render view", llRuns,
+                   llRuns * ptMaze->tFrame.iViewW * ptMaze->tFrame.iViewH, dTime);
+
+  // Random walk in the game's screen, each move sends only the changes.
+  llRuns  = 0;
+  llBytes = 0;
+  llWalk  = llCell;
+  printMaze(ptMaze, iDir, llWalk);
+  dStart = getSeconds();
+  do {
+    iWalkDir = randBits(&ptMaze->tRand, 2);
+    moveInGrid(ptMaze, iWalkDir, &llWalk);
+    frameStart(&ptMaze->tFrame);
+    frameMaze(&ptMaze->tFrame, ptMaze, iWalkDir, llWalk);
+    frameFlush(&ptMaze->tFrame);
+    llBytes += ptMaze->tFrame.sLen;
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("render moves", llRuns, llRuns, dTime);
+  fprintf(stderr, "%-20s %12.1f bytes/move\n", "render moves", (double) llBytes / llRuns);
+
+  // Same walk with the first person view beside the grid.
+  viewInit();
+  sightInit(&tSight, ptMaze);
+  ptMaze->tFrame.b3D = 1;
+  llRuns  = 0;
+  llBytes = 0;
+  printMaze(ptMaze, iDir, llWalk);
+  dStart = getSeconds();
+  do {
+    iWalkDir = randBits(&ptMaze->tRand, 2);
+    moveInGrid(ptMaze, iWalkDir, &llWalk);
+    frameStart(&ptMaze->tFrame);
+    frameMaze(&ptMaze->tFrame, ptMaze, iWalkDir, llWalk);
+    print3DView(&ptMaze->tFrame, &tSight, ptMaze, iWalkDir, llWalk);
+    frameFlush(&ptMaze->tFrame);
+    llBytes += ptMaze->tFrame.sLen;
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  ptMaze->tFrame.b3D = 0;
+  sightFree(&tSight);
+  printBenchResult("render 3d moves", llRuns, llRuns, dTime);
+  fprintf(stderr, "%-20s %12.1f bytes/move\n", "render 3d moves", (double) llBytes / llRuns);
+
+  // Export, same redirection as above.
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    exportMaze(ptMaze, stdout);
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  fflush(stdout);
+  printBenchResult("export", llRuns, llRuns * ptMaze->llMazeCount, dTime);
+
+  // Eller's generator straight into the output, same redirection as above.
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    streamMaze(stdout, ptMaze->iMazeW, ptMaze->iMazeH, ptMaze->llSeed);
+    ++llRuns;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  fflush(stdout);
+  printBenchResult("stream eller", llRuns, llRuns * ptMaze->llMazeCount, dTime);
+
+  // One direction choice per run, old rand() and float path ...
+  fprintf(stderr, "Random draws, items are direction choices\n");
+  srand((unsigned) ptMaze->llSeed);
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    for (int i = 0; i < 1000; ++i) {
+      ui64 += (int) ((float) rand() / (float) RAND_MAX * 2.0f);
+      ui64 += (float) rand() / (float) RAND_MAX > 0.5f;
+    }
+    llRuns += 1000;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("rand() float", llRuns, llRuns, dTime);
+
+  // ... against 3 bits from the reservoir.
+  llRuns = 0;
+  dStart = getSeconds();
+  do {
+    for (int i = 0; i < 1000; ++i)
+      ui64 += randBits(&ptMaze->tRand, 3);
+    llRuns += 1000;
+  } while ((dTime = getSeconds() - dStart) < BENCH_TIME);
+  printBenchResult("xoshiro bits", llRuns, llRuns, dTime);
+
+  // Keep the compiler from dropping the loops.
+  if (ui64 == 42) fprintf(stderr, "\n");
 }
 
 
@@ -741,8 +5439,14 @@ int generateMaze(int* piCell) {
 //* main
 
 int main(int argc, char *argv[]) {
-  int iDir  = 0;
-  int iCell = 0;
+  t_maze  tMaze  = {0};
+  t_dist  tDist  = {0};
+  t_sight tSight = {0};
+  FILE*   hOut   = NULL;
+  int     iDir   = 0;
+  int     bHint  = 0;
+  int     bDist  = 0;
+  ll      llCell = 0;
 
   // Save program's name.
   getMename(&g_csMename, argv[0]);
@@ -750,32 +5454,84 @@ int main(int argc, char *argv[]) {
   // Get options and dispatch errors, if any.
   getOptions(argc, argv);
 
-  initRand();
+  // Batches have a maze per thread, streamed mazes have none at all.
+  if ((g_tOpts.iCount == 0 && ! isStreamed()) || g_tOpts.bBench)
+    if (! mazeInit(&tMaze, g_tOpts.iMazeW, g_tOpts.iMazeH, g_tOpts.bLarge, g_tOpts.llSeed))
+      dispatchError(ERR_ELSE, "Not enough memory for maze");
+  tMaze.iAlgo    = g_tOpts.iAlgo;
+  tMaze.iPolicy  = g_tOpts.iPolicy;
+  tMaze.iMix     = g_tOpts.iMix;
+  tMaze.iThreads = g_tOpts.iThreads;
 
-  // Start game ...
-  iDir = generateMaze(&iCell);
+  // Only measure speed if wanted.
+  if (g_tOpts.bBench) {
+    runBenchmarks(&tMaze);
+    exit(ERR_NOERR);
+  }
 
-// exit(-1); // DEBUG XXX
+  // Benchmarks braid their own mazes.
+  tMaze.iBraid = g_tOpts.iBraid;
 
-  // ... and loop game interactions.
-  while (1) {
-    if (waitForNextKey(&iDir)) {
-      if (moveInGrid(iDir, &iCell) == -1) {
-        break;
+  if (g_tOpts.csOut.len != 0)
+    hOut = strcmp(g_tOpts.csOut.cStr, "-") ? openFile(g_tOpts.csOut.cStr, "w") : stdout;
+
+  // Either build a bunch of mazes ...
+  if (g_tOpts.iCount != 0) {
+    runBatch(hOut);
+  }
+  // ... or stream one without grid ...
+  else if (isStreamed()) {
+    if (! streamMaze(hOut, g_tOpts.iMazeW, g_tOpts.iMazeH, g_tOpts.llSeed))
+      dispatchError(ERR_ELSE, "Not enough memory for maze");
+  }
+  // ... or just write one out and/or solve it ...
+  else if (hOut != NULL || g_tOpts.bSolve || g_tOpts.bStats) {
+    if (generateMaze(&tMaze, &llCell, 0) == -1)
+      dispatchError(ERR_ELSE, "Not enough memory for maze");
+    if (hOut != NULL) exportMaze(&tMaze, hOut);
+    if (g_tOpts.bSolve) printSolution(&tMaze, g_tOpts.iSolver, llCell);
+    if (g_tOpts.bStats) printStats(&tMaze, llCell);
+    if (g_tOpts.bDist)  writeDist(&tMaze, g_tOpts.csOut.cStr);
+  }
+  // ... or start game and loop game interactions.
+  else {
+    if ((iDir = generateMaze(&tMaze, &llCell, g_tOpts.bAnimate)) == -1)
+      dispatchError(ERR_ELSE, "Not enough memory for maze");
+    // The first person view looks up records, large mazes walk the cells.
+    sightInit(&tSight, &tMaze);
+    viewInit();
+    tMaze.tFrame.b3D = 1;
+
+    while (1) {
+      frameStart(&tMaze.tFrame);
+      frameMaze(&tMaze.tFrame, &tMaze, iDir, llCell);
+      // Hints look up the distances once per key, no search. They are built
+      // on the first 'h' only, a failure is not retried and shows no hint.
+      if (bHint && ! bDist) {
+        bDist = 1;
+        distInit(&tDist, &tMaze);
+      }
+      if (bHint) frameHint(&tMaze.tFrame, &tDist, &tMaze, iDir, llCell);
+      print3DView(&tMaze.tFrame, &tSight, &tMaze, iDir, llCell);
+      frameFlush(&tMaze.tFrame);
+      if (waitForNextKey(&iDir, &bHint)) {
+        if (moveInGrid(&tMaze, iDir, &llCell) == -1) {
+          printf("Finished!\n");
+          break;
+        }
       }
     }
-    clearScreen();
-    printMaze(iDir, iCell);
-    print3DView(iDir, iCell);
   }
 
-  printf("Finished!\n");
+  if (hOut != NULL && hOut != stdout) fclose(hOut);
 
   // Free all used memory, prior end of program.
   daFreeEx(g_tArgs, cStr);
   csFree(&g_csMename);
-  free(g_tMaze.piCells);
-  free(g_tStack.piCell);
+  csFree(&g_tOpts.csOut);
+  distFree(&tDist);
+  sightFree(&tSight);
+  mazeFree(&tMaze);
 
   return ERR_NOERR;
 }